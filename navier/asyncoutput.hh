@@ -0,0 +1,267 @@
+#ifndef ASYNCOUTPUT_HH
+#define ASYNCOUTPUT_HH
+
+#include <dune/fem/io/file/vtkio.hh>
+#include <dune/navier/vtuwriter.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/stuff/magnitudefunction.hh>
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <exception>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief writes VTK files of snapshots of the output functions on a background thread
+  * The main thread copies the dofs into a free snapshot slot and continues with the time loop, the worker does the
+  * evaluation, encoding and disk I/O. With max_pending slots in flight the next snapshot blocks until the oldest one
+  * is written. All discrete functions (snapshot buffers and magnitudes) are created and destroyed on the main thread
+  * only, since the DofManager is not thread safe, the worker merely reads them and the grid.
+  */
+template <class GridPartType>
+class AsyncVTKWriter {
+public:
+  typedef SubsamplingVTKIO<GridPartType> VTKIOType;
+  typedef CompressedVTUWriter<GridPartType> CompressedWriterType;
+
+  struct FunctionSnapshotInterface {
+    virtual ~FunctionSnapshotInterface() {}
+    //! main thread: copy the current dofs, \a filename is the output name for this snapshot
+    virtual void copy(const std::string& filename, const bool with_magnitude) = 0;
+    //! worker thread, adds the copy to the writer
+    virtual void add(VTKIOType& vtkio) = 0;
+    virtual void add(CompressedWriterType& writer) = 0;
+    virtual std::string name() const = 0;
+    virtual const std::string& filename() const = 0;
+  };
+
+  template <class DFType>
+  class FunctionSnapshot : public FunctionSnapshotInterface {
+  public:
+    FunctionSnapshot(const DFType& source)
+      : source_(source)
+      , copy_(source.name(), source.space()) {}
+
+    void copy(const std::string& filename, const bool with_magnitude) {
+      filename_ = filename;
+      copy_.assign(source_);
+      // CompressedVTUWriter computes magnitudes itself
+      if (with_magnitude && DFType::FunctionSpaceType::DimRange > 1)
+        magnitude_.reset(new Stuff::MagnitudeFunction<DFType>(copy_));
+    }
+
+    std::string name() const { return source_.name(); }
+    const std::string& filename() const { return filename_; }
+
+    void add(VTKIOType& vtkio) {
+      if (magnitude_) {
+        vtkio.addVectorVertexData(copy_);
+        vtkio.addVectorCellData(copy_);
+        vtkio.addVertexData(magnitude_->discreteFunction());
+        vtkio.addCellData(magnitude_->discreteFunction());
+      } else {
+        vtkio.addVertexData(copy_);
+        vtkio.addCellData(copy_);
+      }
+    }
+
+    void add(CompressedWriterType& writer) { writer.addFunction(copy_); }
+
+  private:
+    const DFType& source_;
+    DFType copy_;
+    boost::scoped_ptr<Stuff::MagnitudeFunction<DFType>> magnitude_;
+    std::string filename_;
+  };
+
+  typedef std::vector<boost::shared_ptr<FunctionSnapshotInterface>> SlotType;
+
+  AsyncVTKWriter(const GridPartType& gridPart, const size_t max_pending)
+    : gridPart_(gridPart)
+    , max_pending_(max_pending)
+    , compression_level_(CompressedWriterType::compressionLevel())
+    , stop_(false)
+    , worker_(&AsyncVTKWriter::work, this) {}
+
+  ~AsyncVTKWriter() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    changed_.notify_all();
+    worker_.join();
+    // owners call flush() when done, this is only reached with an unreported error while unwinding
+    if (!error_.empty())
+      std::cerr << "asynchronous output failed: " << error_ << std::endl;
+  }
+
+  /** \brief blocks until a slot is available and returns its index
+    * an empty slot has to be filled with FunctionSnapshots by the caller, afterwards it keeps them
+    */
+  size_t acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (free_.empty() && slots_.size() >= max_pending_)
+      changed_.wait(lock);
+    throwPendingError();
+    if (free_.empty()) {
+      slots_.push_back(SlotType());
+      return slots_.size() - 1;
+    }
+    const size_t index = free_.back();
+    free_.pop_back();
+    return index;
+  }
+
+  SlotType& slot(const size_t index) { return slots_[index]; }
+
+  //! hand the filled slot to the worker, a non-empty \a single_file collects all functions in that file
+  void submit(const size_t index, const VTKFormat::Type type, const std::string& single_file = "") {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queue_.push_back(Job(index, type, single_file));
+    }
+    changed_.notify_all();
+  }
+
+  //! blocks until everything submitted so far is on disk
+  void flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (free_.size() < slots_.size())
+      changed_.wait(lock);
+    throwPendingError();
+  }
+
+private:
+  struct Job {
+    Job(const size_t _index, const VTKFormat::Type _type, const std::string& _single_file)
+      : index(_index)
+      , type(_type)
+      , single_file(_single_file) {}
+    size_t index;
+    VTKFormat::Type type;
+    std::string single_file;
+  };
+
+  void work() {
+    for (;;) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (queue_.empty() && !stop_)
+        changed_.wait(lock);
+      if (queue_.empty())
+        return;
+      const Job job = queue_.front();
+      queue_.pop_front();
+      SlotType& slot = slots_[job.index];
+      lock.unlock();
+      try {
+        if (job.type == VTKFormat::zlib) {
+          // only ever touched by the worker, keeps the encoded mesh between snapshots
+          if (!compressed_writer_)
+            compressed_writer_.reset(new CompressedWriterType(gridPart_, compression_level_));
+          for (size_t i = 0; i < slot.size(); ++i) {
+            slot[i]->add(*compressed_writer_);
+            if (job.single_file.empty())
+              compressed_writer_->write(slot[i]->filename());
+          }
+          if (!job.single_file.empty())
+            compressed_writer_->write(job.single_file);
+        } else {
+          VTKIOType vtkio(gridPart_, VTKOptions::nonconforming);
+          for (size_t i = 0; i < slot.size(); ++i) {
+            slot[i]->add(vtkio);
+            if (job.single_file.empty()) {
+              vtkio.write(slot[i]->filename().c_str(), VTKFormat::duneType(job.type));
+              vtkio.clear();
+            }
+          }
+          if (!job.single_file.empty())
+            vtkio.write(job.single_file.c_str(), VTKFormat::duneType(job.type));
+        }
+      }
+      // nothing may escape the thread, Logger is not thread safe, the main thread reports this on its next call
+      catch (Dune::Exception& e) {
+        setError(e.what());
+      }
+      catch (std::exception& e) {
+        setError(e.what());
+      }
+      catch (...) {
+        setError("unknown exception");
+      }
+      lock.lock();
+      free_.push_back(job.index);
+      lock.unlock();
+      changed_.notify_all();
+    }
+  }
+
+  //! worker thread, keeps the first error until the main thread throws it
+  void setError(const std::string& error) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (error_.empty())
+      error_ = error;
+  }
+
+  //! expects mutex_ to be locked
+  void throwPendingError() {
+    if (error_.empty())
+      return;
+    const std::string error = error_;
+    error_.clear();
+    DUNE_THROW(IOError, "asynchronous output failed: " << error);
+  }
+
+  const GridPartType& gridPart_;
+  const size_t max_pending_;
+  const int compression_level_;
+  boost::scoped_ptr<CompressedWriterType> compressed_writer_;
+  //! deque so references to slots stay valid while new ones are added
+  std::deque<SlotType> slots_;
+  std::vector<size_t> free_;
+  std::deque<Job> queue_;
+  std::string error_;
+  bool stop_;
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::thread worker_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // ASYNCOUTPUT_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
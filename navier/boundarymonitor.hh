@@ -0,0 +1,209 @@
+#ifndef BOUNDARYMONITOR_HH
+#define BOUNDARYMONITOR_HH
+
+#include <dune/navier/parameterlist.hh>
+#include <dune/fem/quadrature/cachingquadrature.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/stuff/parametercontainer.hh>
+#include <dune/stuff/logging.hh>
+#include <dune/stuff/profiler.hh>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/shared_ptr.hpp>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <algorithm>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief per boundary id integrals of the flow, as a time series
+  * For every id in monitor_boundary_ids (the DGF BOUNDARYSEGMENTS ids) one sweep over the boundary intersections
+  * accumulates
+  * - the volume flux \f$\int u \cdot n\f$ (outward normal, so inflow is negative),
+  * - the mean pressure \f$|\Gamma|^{-1} \int p\f$,
+  * - the force the fluid exerts on the boundary \f$\int p n - \nu (\nabla u + \nabla u^T) n\f$ (drag and lift on a
+  *   wall).
+  * All ranks contribute their intersections to a single sum, rank 0 appends a row to
+  * <datadir>/<datafileprefix>boundary_run<run_key>.csv. With monitor_pressure_drop "a,b" the difference of the mean
+  * pressures on a and b is added as last column. The file is started afresh unless \a append is set, as for a run
+  * resumed from a checkpoint.
+  */
+template <class GridPartType>
+class BoundaryMonitor {
+  typedef typename GridPartType::template Codim<0>::IteratorType IteratorType;
+  typedef typename GridPartType::IntersectionIteratorType IntersectionIteratorType;
+  typedef CachingQuadrature<GridPartType, 1> FaceQuadratureType;
+  static const int dim = GridPartType::GridType::dimensionworld;
+  //! flux, pressure integral, area and the force components
+  static const int columns = 3 + dim;
+
+public:
+  //! true if the parameter file names any boundary ids to monitor
+  static bool enabled() { return Dune::Parameter::exists("monitor_boundary_ids"); }
+
+  BoundaryMonitor(const GridPartType& gridPart, const double viscosity, const bool append)
+    : gridPart_(gridPart)
+    , viscosity_(viscosity)
+    , interval_(Parameters().getParam("monitor_interval", 1, Dune::ValidateNotLess<int>(1)))
+    , ids_(parameterList<int>("monitor_boundary_ids"))
+    , drop_(parameterList<int>("monitor_pressure_drop"))
+    , calls_(0) {
+    if (!drop_.empty() && (drop_.size() != 2 || index(drop_[0]) < 0 || index(drop_[1]) < 0))
+      DUNE_THROW(InvalidStateException, "monitor_pressure_drop needs two of the monitored boundary ids");
+    if (gridPart_.grid().comm().rank() == 0)
+      open(append);
+  }
+
+  //! integrates every monitor_interval-th call, all ranks have to call this
+  template <class VelocityType, class PressureType>
+  void sample(const double time, const VelocityType& velocity, const PressureType& pressure) {
+    if (ids_.empty() || calls_++ % interval_ != 0)
+      return;
+    Stuff::Profiler::ScopedTiming monitor_time("boundary_monitor");
+    typedef typename VelocityType::RangeType VelocityRangeType;
+    typedef typename VelocityType::JacobianRangeType VelocityJacobianType;
+    typedef typename PressureType::RangeType PressureRangeType;
+    typedef typename IntersectionIteratorType::Intersection IntersectionType;
+    const int order = 2 * velocity.space().order();
+    std::vector<double> sums(ids_.size() * columns, 0.0);
+    const IteratorType end = gridPart_.template end<0>();
+    for (IteratorType it = gridPart_.template begin<0>(); it != end; ++it) {
+      if (!it->hasBoundaryIntersections())
+        continue;
+      const typename VelocityType::LocalFunctionType u = velocity.localFunction(*it);
+      const typename PressureType::LocalFunctionType p = pressure.localFunction(*it);
+      const IntersectionIteratorType iend = gridPart_.iend(*it);
+      for (IntersectionIteratorType iit = gridPart_.ibegin(*it); iit != iend; ++iit) {
+        const IntersectionType& intersection = *iit;
+        if (!intersection.boundary() || intersection.neighbor())
+          continue;
+        const int id = index(intersection.boundaryId());
+        if (id < 0)
+          continue;
+        double* sum = &sums[id * columns];
+        const FaceQuadratureType quad(gridPart_, intersection, order, FaceQuadratureType::INSIDE);
+        for (size_t qp = 0; qp < quad.nop(); ++qp) {
+          const typename IntersectionType::LocalCoordinate x = quad.localPoint(qp);
+          const double weight = quad.weight(qp) * intersection.geometry().integrationElement(x);
+          const typename IntersectionType::GlobalCoordinate normal = intersection.unitOuterNormal(x);
+          VelocityRangeType u_value;
+          VelocityJacobianType u_jacobian;
+          PressureRangeType p_value;
+          u.evaluate(quad[qp], u_value);
+          u.jacobian(quad[qp], u_jacobian);
+          p.evaluate(quad[qp], p_value);
+          sum[0] += weight * (u_value * normal);
+          sum[1] += weight * p_value[0];
+          sum[2] += weight;
+          for (int i = 0; i < dim; ++i) {
+            double viscous = 0.0;
+            for (int j = 0; j < dim; ++j)
+              viscous += (u_jacobian[i][j] + u_jacobian[j][i]) * normal[j];
+            sum[3 + i] += weight * (p_value[0] * normal[i] - viscosity_ * viscous);
+          }
+        }
+      }
+    }
+    gridPart_.grid().comm().sum(&sums[0], sums.size());
+    if (gridPart_.grid().comm().rank() == 0)
+      write(time, sums);
+  }
+
+private:
+  //! position of boundary id \a id in ids_, -1 if it is not monitored
+  int index(const int id) const {
+    const std::vector<int>::const_iterator it = std::find(ids_.begin(), ids_.end(), id);
+    return it == ids_.end() ? -1 : int(it - ids_.begin());
+  }
+
+  void open(const bool append) {
+    const std::string directory = Parameters().getParam("fem.io.datadir", std::string("data"));
+    boost::filesystem::create_directories(directory);
+    const std::string filename = (boost::format("%s/%sboundary_run%d.csv") % directory %
+                                  Parameters().getParam("fem.io.datafileprefix", std::string("solu_")) %
+                                  Parameters().getParam("run_key", 0)).str();
+    out_.reset(new std::ofstream(filename.c_str(), append ? std::ios_base::app : std::ios_base::out));
+    if (!*out_)
+      DUNE_THROW(IOError, "could not open " << filename);
+    if (append)
+      return;
+    *out_ << "time";
+    for (size_t i = 0; i < ids_.size(); ++i) {
+      *out_ << ",flux_" << ids_[i] << ",mean_p_" << ids_[i];
+      for (int d = 0; d < dim; ++d)
+        *out_ << ",force" << d << "_" << ids_[i];
+    }
+    if (!drop_.empty())
+      *out_ << ",dp_" << drop_[0] << "_" << drop_[1];
+    *out_ << "\n";
+  }
+
+  void write(const double time, const std::vector<double>& sums) {
+    std::vector<double> row;
+    for (size_t i = 0; i < ids_.size(); ++i) {
+      const double* sum = &sums[i * columns];
+      row.push_back(sum[0]);
+      row.push_back(sum[2] > 0.0 ? sum[1] / sum[2] : 0.0);
+      row.insert(row.end(), sum + 3, sum + columns);
+    }
+    if (!drop_.empty()) {
+      const double* a = &sums[index(drop_[0]) * columns];
+      const double* b = &sums[index(drop_[1]) * columns];
+      row.push_back((a[2] > 0.0 ? a[1] / a[2] : 0.0) - (b[2] > 0.0 ? b[1] / b[2] : 0.0));
+    }
+    char number[32];
+    std::string line((boost::format("%.12g") % time).str());
+    for (size_t i = 0; i < row.size(); ++i) {
+      const int length = snprintf(number, sizeof(number), ",%.10g", row[i]);
+      line.append(number, length);
+    }
+    line += "\n";
+    out_->write(line.data(), line.size());
+    out_->flush();
+  }
+
+  const GridPartType& gridPart_;
+  const double viscosity_;
+  const int interval_;
+  const std::vector<int> ids_;
+  //! the two ids of the pressure drop column, or empty
+  const std::vector<int> drop_;
+  long calls_;
+  boost::shared_ptr<std::ofstream> out_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // BOUNDARYMONITOR_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
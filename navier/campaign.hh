@@ -0,0 +1,180 @@
+#ifndef CAMPAIGN_HH
+#define CAMPAIGN_HH
+
+#include <dune/navier/runinfoexchange.hh>
+#include <dune/stuff/parametercontainer.hh>
+#include <dune/stuff/logging.hh>
+#include <dune/stuff/profiler.hh>
+#include <dune/stuff/misc.hh>
+#include <dune/stuff/runinfo.hh>
+#include <boost/format.hpp>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+
+namespace Dune {
+namespace NavierStokes {
+
+//! one member of a parameter study: the arguments to a single run plus the parameters it needs changed
+struct CampaignJob {
+  typedef std::vector<std::pair<std::string, double>> OverrideList;
+
+  CampaignJob(const int _key, const int _refine_level_factor, const int _scheme_type)
+    : key(_key)
+    , refine_level_factor(_refine_level_factor)
+    , scheme_type(_scheme_type) {}
+
+  //! the entry in the RunInfoTimeMapMap the results end up in
+  int key;
+  int refine_level_factor;
+  int scheme_type;
+  OverrideList overrides;
+};
+
+/** \brief runs the independent jobs of a parameter study, optionally concurrently
+  * With campaign_groups > 1 the world communicator is split into that many groups, job i goes to group
+  * i % groups and every group runs its jobs on its own sub-communicator. Afterwards the results of all jobs are
+  * available on every rank, so a study finishes in the time of its most expensive group instead of the sum of all
+  * runs. Profiler timings are per process, so every group reports them for its own jobs on its own communicator.
+  * With a single group the jobs simply run one after the other on the world communicator.
+  * LoopTimerType reports progress and ETA after each job, it is constructed like Stuff::LoopTimer.
+  */
+template <class CommunicatorType, class LoopTimerType = Stuff::LoopTimer<int, Stuff::Logging::LogStream>>
+class Campaign {
+public:
+  typedef std::vector<CampaignJob> JobList;
+  typedef Stuff::RunInfoTimeMap (*RunFunctionType)(CommunicatorType&, const int, const int);
+  //! called with a group communicator right before it is freed, everything living on it has to go
+  typedef void (*ReleaseFunctionType)(CommunicatorType&);
+
+  Campaign(CommunicatorType& world)
+    : world_(world)
+    , groups_(std::min(Parameters().getParam("campaign_groups", 1, Dune::ValidateNotLess<int>(1)), world.size())) {}
+
+  /** run all jobs, results are stored in \a rf at their key
+    * parameters touched by the job overrides are restored afterwards
+    */
+  void run(const JobList& jobs, RunFunctionType run_function, Stuff::RunInfoTimeMapMap& rf,
+           ReleaseFunctionType release = NULL) {
+    const std::vector<std::pair<std::string, double>> saved = savedParameters(jobs);
+    if (groups_ == 1) {
+      runJobs(jobs, 0, world_, run_function, rf);
+      restoreParameters(saved);
+      profiler().OutputMap(world_, rf);
+      return;
+    }
+#if ENABLE_MPI
+    const int color = world_.rank() % groups_;
+    MPI_Comm group_mpi_comm;
+    MPI_Comm_split(world_, color, world_.rank(), &group_mpi_comm);
+    CommunicatorType group_comm(group_mpi_comm);
+    Logger().Info() << boost::format("campaign: %d jobs on %d groups, this is group %d\n") % jobs.size() % groups_ %
+                           color;
+
+    Stuff::RunInfoTimeMapMap local;
+    runJobs(jobs, color, group_comm, run_function, local);
+    restoreParameters(saved);
+    // the profiler only saw this group's runs, pair them with this group's results
+    profiler().OutputMap(group_comm, local);
+
+    // only the first rank of each group contributes, the group's other ranks hold the same infos
+    const bool contributes = group_comm.rank() == 0;
+    if (release)
+      release(group_comm);
+    MPI_Comm_free(&group_mpi_comm);
+    if (!contributes)
+      local.clear();
+    rf = RunInfoExchange::allMerge(world_, local);
+#endif
+  }
+
+private:
+  //! the jobs of group \a color on \a comm, with per-job data file prefixes when groups run concurrently
+  void runJobs(const JobList& jobs, const int color, CommunicatorType& comm, RunFunctionType run_function,
+               Stuff::RunInfoTimeMapMap& results) const {
+    const std::string prefix = Parameters().getParam("fem.io.datafileprefix", std::string("solu_"));
+    int own_jobs = 0;
+    for (size_t i = 0; i < jobs.size(); ++i)
+      own_jobs += int(i) % groups_ == color;
+    if (groups_ > 1)
+      profiler().Reset(own_jobs);
+    int finished_jobs = 0;
+    LoopTimerType loop_timer(finished_jobs, own_jobs, Logger().Info());
+    for (size_t current_job = 0; current_job < jobs.size(); ++current_job) {
+      if (int(current_job) % groups_ != color)
+        continue;
+      const CampaignJob& job = jobs[current_job];
+      Logger().Info() << boost::format("campaign job %d/%d, key %d\n") % (current_job + 1) % jobs.size() % job.key;
+      for (size_t i = 0; i < job.overrides.size(); ++i)
+        Parameters().setParam(job.overrides[i].first, job.overrides[i].second);
+      // names the job's time series files (probes, boundary monitor)
+      Parameters().setParam("run_key", job.key);
+      // concurrent jobs must not overwrite each other's data files
+      if (groups_ > 1)
+        Parameters().setParam("fem.io.datafileprefix", (boost::format("%sjob%d_") % prefix % job.key).str());
+      results[job.key] = run_function(comm, job.refine_level_factor, job.scheme_type);
+      if (results[job.key].size())
+        results[job.key].begin()->second.refine_level = job.refine_level_factor; // just in case the key changes
+      profiler().NextRun();
+      ++loop_timer;
+    }
+    Parameters().setParam("fem.io.datafileprefix", prefix);
+  }
+
+  static void restoreParameters(const std::vector<std::pair<std::string, double>>& saved) {
+    for (size_t i = 0; i < saved.size(); ++i)
+      Parameters().setParam(saved[i].first, saved[i].second);
+  }
+
+  static std::vector<std::pair<std::string, double>> savedParameters(const JobList& jobs) {
+    std::vector<std::pair<std::string, double>> saved;
+    for (size_t j = 0; j < jobs.size(); ++j) {
+      for (size_t i = 0; i < jobs[j].overrides.size(); ++i) {
+        const std::string& name = jobs[j].overrides[i].first;
+        bool known = false;
+        for (size_t k = 0; k < saved.size(); ++k)
+          known = known || saved[k].first == name;
+        if (!known)
+          saved.push_back(std::make_pair(name, Parameters().getParam(name, jobs[j].overrides[i].second)));
+      }
+    }
+    return saved;
+  }
+
+  CommunicatorType& world_;
+  const int groups_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // CAMPAIGN_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
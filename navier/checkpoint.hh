@@ -0,0 +1,254 @@
+#ifndef CHECKPOINT_HH
+#define CHECKPOINT_HH
+
+#include <dune/common/exceptions.hh>
+#include <dune/stuff/parametercontainer.hh>
+#include <dune/stuff/logging.hh>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <fstream>
+#include <string>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+namespace Dune {
+namespace NavierStokes {
+
+//! bump whenever the layout written by ThetaSchemeBase::writeCheckpoint changes
+static const unsigned int checkpoint_version = 3;
+
+/** \brief gzip compressed binary snapshot file
+  * everything is written raw, snapshots are meant to be read on the same machine type they were written on.
+  * The file is written under a temporary name and only renamed by close(), so an interrupted write never replaces a
+  * good snapshot.
+  */
+class CheckpointOutput {
+public:
+  CheckpointOutput(const std::string& filename, const int compression_level)
+    : filename_(filename)
+    , temp_filename_(filename + ".tmp") {
+    stream_.push(boost::iostreams::gzip_compressor(boost::iostreams::gzip_params(compression_level)));
+    stream_.push(boost::iostreams::file_sink(temp_filename_, std::ios_base::out | std::ios_base::binary));
+    scalar(checkpoint_version);
+  }
+
+  template <class T>
+  void scalar(const T& value) {
+    stream_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  //! counterpart of CheckpointInput::check
+  template <class T>
+  void check(const T& value, const std::string& /*what*/) {
+    scalar(value);
+  }
+
+  template <class DiscreteFunctionType>
+  void function(const DiscreteFunctionType& function) {
+    scalar(int(function.size()));
+    for (typename DiscreteFunctionType::ConstDofIteratorType it = function.dbegin(); it != function.dend(); ++it)
+      scalar(double(*it));
+  }
+
+  void close() {
+    stream_.reset();
+    boost::filesystem::rename(temp_filename_, filename_);
+  }
+
+private:
+  const std::string filename_;
+  const std::string temp_filename_;
+  boost::iostreams::filtering_ostream stream_;
+};
+
+class CheckpointInput {
+public:
+  CheckpointInput(const std::string& filename)
+    : filename_(filename) {
+    if (!boost::filesystem::exists(filename))
+      DUNE_THROW(IOError, "checkpoint " << filename << " does not exist");
+    stream_.push(boost::iostreams::gzip_decompressor());
+    stream_.push(boost::iostreams::file_source(filename, std::ios_base::in | std::ios_base::binary));
+    unsigned int version;
+    scalar(version);
+    if (version != checkpoint_version)
+      DUNE_THROW(IOError, "checkpoint " << filename << " has version " << version << ", expected "
+                                        << checkpoint_version);
+  }
+
+  template <class T>
+  void scalar(T& value) {
+    stream_.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!stream_)
+      DUNE_THROW(IOError, "checkpoint " << filename_ << " is truncated");
+  }
+
+  //! reads a value and throws if it differs from \a expected, used to make sure the snapshot fits the setup
+  template <class T>
+  void check(const T& expected, const std::string& what) {
+    T value;
+    scalar(value);
+    if (value != expected)
+      DUNE_THROW(IOError, "checkpoint " << filename_ << " does not match the current " << what << " (" << value
+                                        << " vs. " << expected << ")");
+  }
+
+  template <class DiscreteFunctionType>
+  void function(DiscreteFunctionType& function) {
+    check(int(function.size()), function.name() + " size");
+    for (typename DiscreteFunctionType::DofIteratorType it = function.dbegin(); it != function.dend(); ++it) {
+      double value;
+      scalar(value);
+      *it = value;
+    }
+  }
+
+private:
+  const std::string filename_;
+  boost::iostreams::filtering_istream stream_;
+};
+
+/** \brief decides when to write snapshots and keeps only the newest few of them
+  * Snapshots go to fem.io.datadir/checkpoints, one file per rank, and a small text file next to them names the
+  * newest one so a restart with "checkpoint_restart: latest" can find it.
+  */
+class CheckpointRotation {
+public:
+  CheckpointRotation(const int rank, const int size)
+    : rank_(rank)
+    , size_(size)
+    , interval_(Parameters().getParam("checkpoint_interval", 0, Dune::ValidateNotLess<int>(0)))
+    , keep_(Parameters().getParam("checkpoint_keep", 2, Dune::ValidateNotLess<int>(1)))
+    , compression_level_(
+          Parameters().getParam("checkpoint_compression", 1, Dune::ValidateInterval<int, true, true>(0, 9)))
+    , directory_(Parameters().getParam("fem.io.datadir", std::string("data")) + "/checkpoints")
+    , basename_((boost::format("%s_rank%d") % Parameters().getParam("fem.io.datafileprefix", std::string("solu_")) %
+                 rank).str()) {
+    if (interval_ > 0) {
+      boost::filesystem::create_directories(directory_);
+      findWritten();
+    }
+  }
+
+  //! true every checkpoint_interval full time steps, never with an interval of 0
+  bool due(const int full_steps) const { return interval_ > 0 && full_steps % interval_ == 0; }
+
+  int compressionLevel() const { return compression_level_; }
+
+  //! file name for the snapshot of \a full_steps
+  std::string filename(const int full_steps) const {
+    return (boost::format("%s/%s_%08d.gz") % directory_ % basename_ % full_steps).str();
+  }
+
+  //! to be called once the snapshot in \a filename is complete, drops snapshots beyond checkpoint_keep
+  void committed(const std::string& filename) {
+    std::ofstream(latestPointer().c_str()) << filename << std::endl;
+    // a restarted run overwrites the snapshots after its restart point
+    written_.erase(std::remove(written_.begin(), written_.end(), filename), written_.end());
+    written_.push_back(filename);
+    while (int(written_.size()) > keep_) {
+      boost::filesystem::remove(written_.front());
+      written_.pop_front();
+    }
+    Logger().Info() << "wrote checkpoint " << filename << std::endl;
+  }
+
+  /** \brief this rank's snapshot selected by checkpoint_restart, empty for a fresh start
+    * checkpoint_restart is "latest", a full step number, or the snapshot file of any rank, which is mapped to the
+    * file of the same step written by this rank.
+    */
+  std::string restartFile() const {
+    const std::string restart = Parameters().getParam("checkpoint_restart", std::string());
+    if (restart.empty())
+      return restart;
+    if (restart.find_first_not_of("0123456789") == std::string::npos)
+      return filename(boost::lexical_cast<int>(restart));
+    if (restart != "latest")
+      return rankFile(restart);
+    std::ifstream pointer(latestPointer().c_str());
+    std::string filename;
+    if (!(pointer >> filename))
+      DUNE_THROW(IOError, "no checkpoint recorded in " << latestPointer());
+    return filename;
+  }
+
+private:
+  //! \a filename with the rank in its "_rank<r>_" part replaced by this rank
+  std::string rankFile(const std::string& filename) const {
+    const size_t begin = filename.rfind("_rank");
+    const size_t digits = begin == std::string::npos ? begin : begin + 5;
+    const size_t end = digits == std::string::npos ? digits : filename.find('_', digits);
+    if (end == std::string::npos || end == digits ||
+        filename.substr(digits, end - digits).find_first_not_of("0123456789") != std::string::npos) {
+      if (size_ > 1)
+        DUNE_THROW(IOError, "checkpoint_restart " << filename << " names no rank, cannot restart " << size_
+                                                  << " ranks from it");
+      return filename;
+    }
+    return (boost::format("%s%d%s") % filename.substr(0, digits) % rank_ % filename.substr(end)).str();
+  }
+
+  //! snapshots of earlier runs with the same prefix take part in the rotation, oldest first
+  void findWritten() {
+    const std::string prefix = basename_ + "_";
+    std::vector<std::string> found;
+    for (boost::filesystem::directory_iterator it(directory_); it != boost::filesystem::directory_iterator(); ++it) {
+      const std::string name = it->path().filename().string();
+      // the fixed width step number makes the file names sort by step
+      if (name.size() == prefix.size() + 11 && boost::starts_with(name, prefix) && boost::ends_with(name, ".gz"))
+        found.push_back(directory_ + "/" + name);
+    }
+    std::sort(found.begin(), found.end());
+    written_.assign(found.begin(), found.end());
+  }
+
+  std::string latestPointer() const { return directory_ + "/" + basename_ + "_latest"; }
+
+  const int rank_;
+  const int size_;
+  const int interval_;
+  const int keep_;
+  const int compression_level_;
+  const std::string directory_;
+  const std::string basename_;
+  std::deque<std::string> written_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // CHECKPOINT_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
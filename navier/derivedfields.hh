@@ -0,0 +1,172 @@
+#ifndef DERIVEDFIELDS_HH
+#define DERIVEDFIELDS_HH
+
+#include <dune/navier/parameterlist.hh>
+#include <dune/fem/quadrature/cachingquadrature.hh>
+#include <dune/fem/operator/1order/localmassmatrix.hh>
+#include <dune/common/tuples.hh>
+#include <dune/common/typetraits.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/stuff/parametercontainer.hh>
+#include <dune/stuff/profiler.hh>
+#include <boost/scoped_ptr.hpp>
+#include <vector>
+#include <string>
+#include <cmath>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief scalar fields computed from the velocity for output only: magnitude, vorticity and divergence
+  * derived_fields selects any of them ("magnitude;vorticity;divergence"). Each selected field is a persistent
+  * buffer in the scalar (pressure) space, update() refreshes all of them in one sweep over the elements, evaluating
+  * the velocity and its jacobian once per quadrature point and L2-projecting elementwise. The vorticity is the
+  * scalar curl in 2d and the magnitude of the curl in 3d. Without derived_fields only the magnitude is computed.
+  * tuple() holds the selected fields first, in the order above, and NULL for the rest, which the data writers skip.
+  */
+template <class VelocityFunctionType, class ScalarFunctionType>
+class DerivedFields {
+  typedef typename ScalarFunctionType::DiscreteFunctionSpaceType ScalarSpaceType;
+  typedef CachingQuadrature<typename ScalarSpaceType::GridPartType, 0> QuadratureType;
+
+public:
+  typedef Dune::tuple<ScalarFunctionType*, ScalarFunctionType*, ScalarFunctionType*> TupleType;
+
+  DerivedFields(const ScalarSpaceType& space)
+    : space_(space)
+    , tuple_(NULL, NULL, NULL) {
+    const std::vector<std::string> names = parameterList<std::string>("derived_fields", "magnitude");
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (names[i] == "magnitude")
+        magnitude_.reset(new ScalarFunctionType("velocity_magnitude", space_));
+      else if (names[i] == "vorticity")
+        vorticity_.reset(new ScalarFunctionType("vorticity", space_));
+      else if (names[i] == "divergence")
+        divergence_.reset(new ScalarFunctionType("divergence", space_));
+      else
+        DUNE_THROW(InvalidStateException, "unknown derived field " << names[i]);
+    }
+    // the data writer takes its grid part from the first entry
+    ScalarFunctionType* selected[3] = {NULL, NULL, NULL};
+    ScalarFunctionType* const fields[3] = {magnitude_.get(), vorticity_.get(), divergence_.get()};
+    for (int f = 0, count = 0; f < 3; ++f)
+      if (fields[f])
+        selected[count++] = fields[f];
+    tuple_ = TupleType(selected[0], selected[1], selected[2]);
+  }
+
+  bool empty() const { return !magnitude_ && !vorticity_ && !divergence_; }
+
+  //! the data writer keeps a reference, so this lives as long as the object
+  TupleType& tuple() { return tuple_; }
+
+  void update(const VelocityFunctionType& velocity) {
+    if (empty())
+      return;
+    Stuff::Profiler::ScopedTiming derived_time("derived_fields");
+    typedef typename ScalarSpaceType::IteratorType IteratorType;
+    typedef typename ScalarFunctionType::LocalFunctionType ScalarLocalFunctionType;
+    typedef typename VelocityFunctionType::RangeType VelocityRangeType;
+    typedef typename VelocityFunctionType::JacobianRangeType VelocityJacobianType;
+    static const int dim = VelocityRangeType::dimension;
+    ScalarFunctionType* const fields[3] = {magnitude_.get(), vorticity_.get(), divergence_.get()};
+    for (int f = 0; f < 3; ++f)
+      if (fields[f])
+        fields[f]->clear();
+    const int order = space_.order() + velocity.space().order();
+    LocalMassMatrix<ScalarSpaceType, QuadratureType> mass_matrix(space_, 2 * space_.order());
+    const IteratorType end = space_.end();
+    for (IteratorType it = space_.begin(); it != end; ++it) {
+      const typename VelocityFunctionType::LocalFunctionType u = velocity.localFunction(*it);
+      std::vector<ScalarLocalFunctionType> local;
+      for (int f = 0; f < 3; ++f)
+        if (fields[f])
+          local.push_back(fields[f]->localFunction(*it));
+      const QuadratureType quad(*it, order);
+      for (size_t qp = 0; qp < quad.nop(); ++qp) {
+        VelocityRangeType value;
+        VelocityJacobianType jacobian;
+        u.evaluate(quad[qp], value);
+        u.jacobian(quad[qp], jacobian);
+        const double weight = quad.weight(qp) * it->geometry().integrationElement(quad.point(qp));
+        size_t l = 0;
+        if (fields[0])
+          add(local[l++], quad[qp], weight * value.two_norm());
+        if (fields[1])
+          add(local[l++], quad[qp], weight * vorticity(jacobian, Int2Type<dim>()));
+        if (fields[2]) {
+          double divergence = 0.0;
+          for (int d = 0; d < dim; ++d)
+            divergence += jacobian[d][d];
+          add(local[l++], quad[qp], weight * divergence);
+        }
+      }
+      for (size_t l = 0; l < local.size(); ++l)
+        mass_matrix.applyInverse(*it, local[l]);
+    }
+  }
+
+private:
+  template <class LocalFunctionType, class PointType>
+  static void add(LocalFunctionType& lf, const PointType& x, const double value) {
+    typename ScalarFunctionType::RangeType weighted(value);
+    lf.axpy(x, weighted);
+  }
+
+  template <class JacobianType>
+  static double vorticity(const JacobianType& jacobian, Int2Type<2>) {
+    return jacobian[1][0] - jacobian[0][1];
+  }
+
+  template <class JacobianType>
+  static double vorticity(const JacobianType& jacobian, Int2Type<3>) {
+    const double x = jacobian[2][1] - jacobian[1][2];
+    const double y = jacobian[0][2] - jacobian[2][0];
+    const double z = jacobian[1][0] - jacobian[0][1];
+    return std::sqrt(x * x + y * y + z * z);
+  }
+
+  template <class JacobianType, int d>
+  static double vorticity(const JacobianType& /*jacobian*/, Int2Type<d>) {
+    return 0.0;
+  }
+
+  const ScalarSpaceType& space_;
+  boost::scoped_ptr<ScalarFunctionType> magnitude_;
+  boost::scoped_ptr<ScalarFunctionType> vorticity_;
+  boost::scoped_ptr<ScalarFunctionType> divergence_;
+  TupleType tuple_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // DERIVEDFIELDS_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
@@ -0,0 +1,167 @@
+#ifndef ERRORKERNEL_HH
+#define ERRORKERNEL_HH
+
+#include <dune/fem/quadrature/cachingquadrature.hh>
+#include <dune/stuff/profiler.hh>
+#include <algorithm>
+#include <cmath>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief everything ThetaSchemeBase::nextStep reports about the error, computed in a single sweep
+  * Each element is visited once with one quadrature of the higher of the two orders. The analytical velocity and
+  * pressure are evaluated directly at the quadrature points, their gradients by central differences (the problem
+  * classes only provide values), so neither the exact solution needs to be projected nor error functions assembled.
+  * A single sum over the communicator gives the L2 and H1 norms of the velocity and pressure errors, the norms of
+  * the exact solution for the relative errors, and the integrals of the exact and the discrete pressure. The H1 norms
+  * are full norms (L2 part included) like Dune::H1Norm.
+  */
+template <class GridPartType>
+class ErrorKernel {
+  typedef CachingQuadrature<GridPartType, 0> QuadratureType;
+
+public:
+  struct Result {
+    double l2_error_velocity;
+    double l2_error_pressure;
+    double h1_error_velocity;
+    double h1_error_pressure;
+    //! norms of the exact solution
+    double l2_velocity;
+    double l2_pressure;
+    double h1_velocity;
+    double mean_pressure_exact;
+    double mean_pressure_discrete;
+  };
+
+  ErrorKernel(const GridPartType& gridPart)
+    : gridPart_(gridPart) {}
+
+  //! \param exact_velocity \param exact_pressure the analytical solution, compared to \a velocity and \a pressure
+  template <class AnalyticalVelocityType, class AnalyticalPressureType, class VelocityType, class PressureType>
+  Result compute(const AnalyticalVelocityType& exact_velocity, const AnalyticalPressureType& exact_pressure,
+                 const VelocityType& velocity, const PressureType& pressure) const {
+    Stuff::Profiler::ScopedTiming kernel_time("error_kernel");
+    typedef typename VelocityType::DiscreteFunctionSpaceType::IteratorType IteratorType;
+    typedef typename VelocityType::RangeType VelocityRangeType;
+    typedef typename VelocityType::JacobianRangeType VelocityJacobianType;
+    typedef typename PressureType::RangeType PressureRangeType;
+    typedef typename PressureType::JacobianRangeType PressureJacobianType;
+    typedef typename VelocityType::DomainType DomainType;
+    static const int dim = DomainType::dimension;
+    enum {
+      l2_u,
+      l2_p,
+      h1_semi_u,
+      h1_semi_p,
+      exact_l2_u,
+      exact_l2_p,
+      exact_h1_semi_u,
+      integral_exact_p,
+      integral_p,
+      count
+    };
+    double sums[count];
+    std::fill(sums, sums + count, 0.0);
+    const int order = 2 * std::max(velocity.space().order(), pressure.space().order());
+    const IteratorType end = velocity.space().end();
+    for (IteratorType it = velocity.space().begin(); it != end; ++it) {
+      const typename VelocityType::LocalFunctionType u = velocity.localFunction(*it);
+      const typename PressureType::LocalFunctionType p = pressure.localFunction(*it);
+      // difference step relative to the element size
+      const double h = 1e-5 * std::pow(it->geometry().volume(), 1.0 / dim);
+      const QuadratureType quad(*it, order);
+      for (size_t qp = 0; qp < quad.nop(); ++qp) {
+        const double weight = quad.weight(qp) * it->geometry().integrationElement(quad.point(qp));
+        const DomainType x = it->geometry().global(quad.point(qp));
+        VelocityRangeType u_exact_value, u_value;
+        VelocityJacobianType u_exact_jacobian, u_jacobian;
+        PressureRangeType p_exact_value, p_value;
+        PressureJacobianType p_exact_jacobian, p_jacobian;
+        exact_velocity.evaluate(x, u_exact_value);
+        exact_pressure.evaluate(x, p_exact_value);
+        for (int d = 0; d < dim; ++d) {
+          DomainType forward(x), backward(x);
+          forward[d] += h;
+          backward[d] -= h;
+          VelocityRangeType u_forward, u_backward;
+          PressureRangeType p_forward, p_backward;
+          exact_velocity.evaluate(forward, u_forward);
+          exact_velocity.evaluate(backward, u_backward);
+          exact_pressure.evaluate(forward, p_forward);
+          exact_pressure.evaluate(backward, p_backward);
+          for (int r = 0; r < int(VelocityRangeType::dimension); ++r)
+            u_exact_jacobian[r][d] = (u_forward[r] - u_backward[r]) / (2 * h);
+          p_exact_jacobian[0][d] = (p_forward[0] - p_backward[0]) / (2 * h);
+        }
+        u.evaluate(quad[qp], u_value);
+        u.jacobian(quad[qp], u_jacobian);
+        p.evaluate(quad[qp], p_value);
+        p.jacobian(quad[qp], p_jacobian);
+
+        sums[exact_l2_u] += weight * u_exact_value.two_norm2();
+        sums[exact_l2_p] += weight * p_exact_value.two_norm2();
+        sums[exact_h1_semi_u] += weight * u_exact_jacobian.frobenius_norm2();
+        sums[integral_exact_p] += weight * p_exact_value[0];
+        sums[integral_p] += weight * p_value[0];
+        u_exact_value -= u_value;
+        u_exact_jacobian -= u_jacobian;
+        p_exact_value -= p_value;
+        p_exact_jacobian -= p_jacobian;
+        sums[l2_u] += weight * u_exact_value.two_norm2();
+        sums[l2_p] += weight * p_exact_value.two_norm2();
+        sums[h1_semi_u] += weight * u_exact_jacobian.frobenius_norm2();
+        sums[h1_semi_p] += weight * p_exact_jacobian.frobenius_norm2();
+      }
+    }
+    gridPart_.grid().comm().sum(sums, count);
+    Result result;
+    result.l2_error_velocity = std::sqrt(sums[l2_u]);
+    result.l2_error_pressure = std::sqrt(sums[l2_p]);
+    result.h1_error_velocity = std::sqrt(sums[l2_u] + sums[h1_semi_u]);
+    result.h1_error_pressure = std::sqrt(sums[l2_p] + sums[h1_semi_p]);
+    result.l2_velocity = std::sqrt(sums[exact_l2_u]);
+    result.l2_pressure = std::sqrt(sums[exact_l2_p]);
+    result.h1_velocity = std::sqrt(sums[exact_l2_u] + sums[exact_h1_semi_u]);
+    result.mean_pressure_exact = sums[integral_exact_p];
+    result.mean_pressure_discrete = sums[integral_p];
+    return result;
+  }
+
+private:
+  const GridPartType& gridPart_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // ERRORKERNEL_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
@@ -0,0 +1,150 @@
+#ifndef DUNE_NAVIER_FIXEDPOINT_HH
+#define DUNE_NAVIER_FIXEDPOINT_HH
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/stuff/logging.hh>
+#include <boost/shared_ptr.hpp>
+#include <deque>
+#include <cmath>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief Anderson acceleration for the fixed point iteration \f$x_{k+1} = G(x_k)\f$
+  * keeps the last \a depth differences of iterates and residuals \f$r_k = G(x_k) - x_k\f$ and mixes them as
+  * \f$x_{k+1} = x_k + r_k - \sum_i \gamma_i (\Delta x_i + \Delta r_i)\f$, where \f$\gamma\f$ minimizes
+  * \f$\| r_k - \sum_i \gamma_i \Delta r_i \|\f$. Depth 0 is plain Picard iteration.
+  */
+template <class DiscreteFunctionType>
+class AndersonAcceleration {
+  typedef boost::shared_ptr<DiscreteFunctionType> FunctionPtr;
+
+public:
+  AndersonAcceleration(const typename DiscreteFunctionType::DiscreteFunctionSpaceType& space, const int depth)
+    : space_(space)
+    , depth_(depth)
+    , previous_x_("anderson_previous_x", space)
+    , previous_r_("anderson_previous_r", space)
+    , residual_("anderson_residual", space)
+    , have_previous_(false) {}
+
+  //! drop the history, call before the iteration of every new sub-step
+  void reset() {
+    delta_x_.clear();
+    delta_r_.clear();
+    have_previous_ = false;
+  }
+
+  /** \brief overwrites \a x (the current iterate) with the next iterate, given \a g = G(x)
+    * \return the norm of the residual G(x) - x
+    */
+  double update(DiscreteFunctionType& x, const DiscreteFunctionType& g) {
+    residual_.assign(g);
+    residual_ -= x;
+    const double residual_norm = std::sqrt(residual_.scalarProductDofs(residual_));
+    if (depth_ < 1) {
+      x.assign(g);
+      return residual_norm;
+    }
+    if (have_previous_) {
+      FunctionPtr dx(recycle());
+      dx->assign(x);
+      *dx -= previous_x_;
+      FunctionPtr dr(recycle());
+      dr->assign(residual_);
+      *dr -= previous_r_;
+      delta_x_.push_back(dx);
+      delta_r_.push_back(dr);
+      if (int(delta_x_.size()) > depth_) {
+        spare_.push_back(delta_x_.front());
+        spare_.push_back(delta_r_.front());
+        delta_x_.pop_front();
+        delta_r_.pop_front();
+      }
+    }
+    previous_x_.assign(x);
+    previous_r_.assign(residual_);
+    have_previous_ = true;
+
+    x.assign(g);
+    const int m = delta_r_.size();
+    if (m == 0)
+      return residual_norm;
+    // normal equations of the least squares problem, m is tiny
+    DynamicMatrix<double> gram(m, m);
+    DynamicVector<double> rhs(m), gamma(m);
+    for (int i = 0; i < m; ++i) {
+      rhs[i] = delta_r_[i]->scalarProductDofs(residual_);
+      for (int j = 0; j <= i; ++j)
+        gram[i][j] = gram[j][i] = delta_r_[i]->scalarProductDofs(*delta_r_[j]);
+      // Tikhonov regularization against nearly linear dependent differences
+      gram[i][i] *= 1.0 + 1e-10;
+    }
+    try {
+      gram.solve(gamma, rhs);
+    }
+    catch (Dune::FMatrixError& e) {
+      Logger().Dbg() << "Anderson: singular least squares problem, falling back to Picard step" << std::endl;
+      reset();
+      return residual_norm;
+    }
+    for (int i = 0; i < m; ++i) {
+      x.addScaled(*delta_x_[i], -gamma[i]);
+      x.addScaled(*delta_r_[i], -gamma[i]);
+    }
+    return residual_norm;
+  }
+
+private:
+  FunctionPtr recycle() {
+    if (spare_.empty())
+      return FunctionPtr(new DiscreteFunctionType("anderson_history", space_));
+    FunctionPtr ret = spare_.back();
+    spare_.pop_back();
+    return ret;
+  }
+
+  const typename DiscreteFunctionType::DiscreteFunctionSpaceType& space_;
+  const int depth_;
+  DiscreteFunctionType previous_x_;
+  DiscreteFunctionType previous_r_;
+  DiscreteFunctionType residual_;
+  bool have_previous_;
+  std::deque<FunctionPtr> delta_x_;
+  std::deque<FunctionPtr> delta_r_;
+  std::deque<FunctionPtr> spare_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // DUNE_NAVIER_FIXEDPOINT_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
@@ -2,8 +2,21 @@
 #define FRACTIONALDATAWRITER_HH
 
 #include <dune/fem/io/file/datawriter.hh>
+#include <dune/fem/space/common/dofmanager.hh>
 #include <dune/grid/io/file/vtk/vtkwriter.hh>
 #include <dune/stuff/magnitudefunction.hh>
+#include <dune/stuff/profiler.hh>
+#include <dune/stuff/logging.hh>
+#include <dune/navier/asyncoutput.hh>
+#include <dune/navier/vtuwriter.hh>
+#include <dune/navier/xdmfwriter.hh>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <type_traits>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <cstdio>
 #include "fractionaltimeprovider.hh"
 
 namespace Dune {
@@ -27,13 +40,48 @@ protected:
   using BaseType::saveTime_;
   using BaseType::saveStep_;
 
+  typedef typename std::remove_pointer<typename tuple_element<0, OutputTupleType>::type>::type FirstFunctionType;
+  typedef typename FirstFunctionType::DiscreteFunctionSpaceType::GridPartType OutputGridPartType;
+  typedef AsyncVTKWriter<OutputGridPartType> AsyncWriterType;
+  typedef CompressedVTUWriter<OutputGridPartType> CompressedWriterType;
+#if ENABLE_HDF5
+  typedef XdmfWriter<OutputGridPartType> XdmfWriterType;
+#endif
+
 public:
-  TimeAwareDataWriter(const TimeproviderType& timeprovider, const GridType& grid, OutputTupleType& tuple)
+  //! \param name distinguishes the files of several writers in single file and hdf5 mode
+  TimeAwareDataWriter(const TimeproviderType& timeprovider, const GridType& grid, OutputTupleType& tuple,
+                      const std::string& name = "solution")
     : BaseType(grid, tuple, timeprovider)
-    , timeprovider_(timeprovider) {}
+    , timeprovider_(timeprovider)
+    , name_(name)
+    , async_queue_(Parameters().getParam("async_output", false)
+                       ? Parameters().getParam("async_output_queue", 2, Dune::ValidateNotLess<int>(1))
+                       : 0)
+    , vtk_format_(VTKFormat::fromParameters())
+    , hdf5_output_(Parameters().getParam("hdf5_output", false))
+    , single_file_(Parameters().getParam("vtk_single_file", false))
+    , gnuplot_binary_(Parameters().getParam("gnuplot_binary", false))
+    , vtk_magnitude_(Parameters().getParam("vtk_magnitude", false))
+    , warmed_up_(false) {
+#if !ENABLE_HDF5
+    if (hdf5_output_)
+      DUNE_THROW(NotImplemented, "hdf5_output needs a build with ENABLE_HDF5");
+#endif
+  }
 
   void write() const { write(timeprovider_.time(), timeprovider_.timeStep()); }
 
+  //! blocks until the asynchronous output is on disk, throws if the background writer failed
+  void flush() const {
+    if (async_writer_)
+      async_writer_->flush();
+  }
+
+  //! number of the next output file, saved in checkpoints so a restarted run continues the numbering
+  int writeStep() const { return writeStep_; }
+  void setWriteStep(const int step) { writeStep_ = step; }
+
   /** \brief write given data to disc
      \param[in] time actual time of computation
      \param[in] timestep current number of time step
@@ -47,7 +95,9 @@ public:
         BaseType::display();
       }
 
-      if (outputFormat_ == vtk || outputFormat_ == vtkvtx) {
+      if (hdf5_output_) {
+        writeXdmfOutput(time, get<0>(data_));
+      } else if (outputFormat_ == vtk || outputFormat_ == vtkvtx) {
         // write data in vtk output format
         writeVTKOutput(get<0>(data_));
       } else if (outputFormat_ == gnuplot) {
@@ -70,7 +120,38 @@ public:
   }
 
 protected:
+  //! open gnuplot files and the quadrature point coordinates per polynomial order of the current grid
+  struct GnuplotCache {
+    GnuplotCache()
+      : sequence(-1) {}
+    int sequence;
+    std::map<int, std::vector<double>> coordinates;
+    std::map<std::string, boost::shared_ptr<std::ofstream>> files;
+  };
+
   const TimeproviderType& timeprovider_;
+  const std::string name_;
+  //! maximal number of snapshots the background writer may lag behind, 0 writes synchronously
+  const int async_queue_;
+  const VTKFormat::Type vtk_format_;
+  //! replaces the per step vtk/gnuplot files with one HDF5 file and an XDMF index
+  const bool hdf5_output_;
+  //! all functions of one step in a single vtk file named after name_ instead of one file per function
+  const bool single_file_;
+  //! raw doubles per point instead of text, for gnuplot's binary format
+  const bool gnuplot_binary_;
+  //! Dune::VTKWriter output gets a magnitude per vector function, projected into a new function on every write
+  const bool vtk_magnitude_;
+  mutable GnuplotCache gnuplot_cache_;
+  //! the first output is written synchronously, so that lazily filled caches of dune-fem are not filled concurrently
+  mutable bool warmed_up_;
+  mutable boost::scoped_ptr<AsyncWriterType> async_writer_;
+  //! kept alive between writes since it caches the encoded mesh
+  mutable boost::scoped_ptr<CompressedWriterType> compressed_writer_;
+#if ENABLE_HDF5
+  //! holds the open HDF5 file for the whole run
+  mutable boost::scoped_ptr<XdmfWriterType> xdmf_writer_;
+#endif
   static inline std::string genFilename(const std::string& path, const std::string& fn, int ntime, int precision = 6) {
     std::ostringstream name;
 
@@ -129,12 +210,16 @@ protected:
   template <class VTKOut>
   class VTKOutputter {
   public:
-    //! Constructor
-    VTKOutputter(VTKOut& vtkOut, std::string path, bool parallel, int step)
+    //! Constructor, with a non-empty \a single_file all functions go to that file in finish()
+    VTKOutputter(VTKOut& vtkOut, std::string path, bool parallel, int step, VTK::OutputType type,
+                 const std::string& single_file = "", const bool with_magnitude = true)
       : vtkOut_(vtkOut)
       , path_(path)
       , parallel_(parallel)
-      , step_(step) {}
+      , step_(step)
+      , type_(type)
+      , single_file_(single_file)
+      , with_magnitude_(with_magnitude) {}
 
     //! Applies the setting on every DiscreteFunction/LocalFunction pair.
     template <class DFType>
@@ -142,39 +227,143 @@ protected:
       if (!f)
         return;
 
-      // needs to in same scope as clear() ?
-      Stuff::MagnitudeFunction<DFType> magnitude(*f);
-
-      std::string name = genFilename((parallel_) ? "" : path_, f->name(), step_);
       if (DFType::FunctionSpaceType::DimRange > 1) {
         vtkOut_.addVectorVertexData(*f);
         vtkOut_.addVectorCellData(*f);
-        vtkOut_.addVertexData(magnitude.discreteFunction());
-        vtkOut_.addCellData(magnitude.discreteFunction());
+        if (with_magnitude_) {
+          // vtkOut_ only keeps a pointer, the magnitude has to live until the file is written
+          boost::shared_ptr<Stuff::MagnitudeFunction<DFType>> magnitude(new Stuff::MagnitudeFunction<DFType>(*f));
+          magnitudes_.push_back(magnitude);
+          vtkOut_.addVertexData(magnitude->discreteFunction());
+          vtkOut_.addCellData(magnitude->discreteFunction());
+        }
       } else {
         vtkOut_.addVertexData(*f);
         vtkOut_.addCellData(*f);
       }
-      const bool binary_output = Parameters().getParam("binary_vtk", true);
+      if (single_file_.empty())
+        write(f->name());
+    }
+
+    void finish() {
+      if (!single_file_.empty())
+        write(single_file_);
+    }
 
+  private:
+    void write(const std::string& basename) {
+      std::string name = genFilename((parallel_) ? "" : path_, basename, step_);
       if (parallel_) {
         // write all data for parallel runs
-        vtkOut_.pwrite(name.c_str(), path_.c_str(), ".", binary_output ? Dune::VTK::base64 : Dune::VTK::ascii);
+        vtkOut_.pwrite(name.c_str(), path_.c_str(), ".", type_);
       } else {
         // write all data serial
-        vtkOut_.write(name.c_str(), binary_output ? Dune::VTK::base64 : Dune::VTK::ascii);
+        vtkOut_.write(name.c_str(), type_);
       }
 
       vtkOut_.clear();
+      magnitudes_.clear();
     }
 
-  private:
     VTKOut& vtkOut_;
     const std::string path_;
     const bool parallel_;
     const int step_;
+    const VTK::OutputType type_;
+    const std::string single_file_;
+    const bool with_magnitude_;
+    std::vector<boost::shared_ptr<void>> magnitudes_;
+  };
+
+  //! one compressed .vtu per function or a single one for all, like VTKOutputter
+  struct CompressedOutputter {
+    CompressedWriterType& writer_;
+    const std::string path_;
+    const int step_;
+    const std::string single_file_;
+    CompressedOutputter(CompressedWriterType& writer, const std::string& path, const int step,
+                        const std::string& single_file)
+      : writer_(writer)
+      , path_(path)
+      , step_(step)
+      , single_file_(single_file) {}
+    template <class DFType>
+    void visit(DFType* f) {
+      if (!f)
+        return;
+      writer_.addFunction(*f);
+      if (single_file_.empty())
+        writer_.write(genFilename(path_, f->name(), step_));
+    }
+    void finish() {
+      if (!single_file_.empty())
+        writer_.write(genFilename(path_, single_file_, step_));
+    }
+  };
+
+  //! file name base of the combined file, empty for one file per function
+  std::string singleFile() const { return single_file_ ? datapref_ + name_ + "_" : std::string(); }
+
+#if ENABLE_HDF5
+  struct XdmfCollector {
+    XdmfWriterType& writer_;
+    XdmfCollector(XdmfWriterType& writer) : writer_(writer) {}
+    template <class DFType>
+    void visit(DFType* f) {
+      if (f)
+        writer_.addFunction(*f);
+    }
+  };
+#endif
+
+  template <class DFType>
+  void writeXdmfOutput(const double time, const DFType* func) const {
+#if ENABLE_HDF5
+    if (!func)
+      return;
+    if (!xdmf_writer_)
+      xdmf_writer_.reset(new XdmfWriterType(func->space().gridPart(),
+                                            (path_.empty() ? "" : path_ + "/") + datapref_ + name_,
+                                            XdmfWriterType::compressionLevel()));
+    ForEachValue<OutputTupleType> forEach(data_);
+    XdmfCollector collector(*xdmf_writer_);
+    forEach.apply(collector);
+    xdmf_writer_->write(time);
+#endif
+  }
+
+  //! fills an empty slot of the asynchronous writer with snapshots of all functions in the tuple
+  struct SnapshotCollector {
+    typename AsyncWriterType::SlotType& slot_;
+    SnapshotCollector(typename AsyncWriterType::SlotType& slot) : slot_(slot) {}
+    template <class DFType>
+    void visit(DFType* f) {
+      if (f)
+        slot_.push_back(boost::shared_ptr<typename AsyncWriterType::FunctionSnapshotInterface>(
+            new typename AsyncWriterType::template FunctionSnapshot<DFType>(*f)));
+    }
   };
 
+  template <class DFType>
+  void writeAsync(const DFType* func) const {
+    if (!async_writer_)
+      async_writer_.reset(new AsyncWriterType(func->space().gridPart(), async_queue_));
+    const size_t index = async_writer_->acquire();
+    typename AsyncWriterType::SlotType& slot = async_writer_->slot(index);
+    if (slot.empty()) {
+      ForEachValue<OutputTupleType> forEach(data_);
+      SnapshotCollector collector(slot);
+      forEach.apply(collector);
+    }
+    for (size_t i = 0; i < slot.size(); ++i)
+      slot[i]->copy(genFilename(path_, slot[i]->name(), timeprovider_.timeStep()),
+                    vtk_magnitude_ && vtk_format_ != VTKFormat::zlib);
+    const std::string single_file = singleFile();
+    async_writer_->submit(
+        index, vtk_format_,
+        single_file.empty() ? single_file : genFilename(path_, single_file, timeprovider_.timeStep()));
+  }
+
   template <class DFType>
   void writeVTKOutput(const DFType* func) const {
     if (!func)
@@ -183,6 +372,25 @@ protected:
     // check whether we have parallel run
     const bool parallel = (grid_.comm().size() > 1);
 
+    // parallel output may communicate, so it stays on the main thread
+    if (async_queue_ > 0 && !parallel && warmed_up_) {
+      Stuff::Profiler::ScopedTiming snapshot_time("IO_snapshot");
+      writeAsync(func);
+      return;
+    }
+    warmed_up_ = true;
+
+    if (vtk_format_ == VTKFormat::zlib) {
+      if (!compressed_writer_)
+        compressed_writer_.reset(
+            new CompressedWriterType(func->space().gridPart(), CompressedWriterType::compressionLevel()));
+      ForEachValue<OutputTupleType> forEach(data_);
+      CompressedOutputter io(*compressed_writer_, path_, timeprovider_.timeStep(), singleFile());
+      forEach.apply(io);
+      io.finish();
+      return;
+    }
+
     // generate filename, with path only for serial run
     {
       // get grid part
@@ -196,8 +404,10 @@ protected:
 
         // add all functions
         ForEachValue<OutputTupleType> forEach(data_);
-        VTKOutputter<VTKIOType> io(vtkio, path_, parallel, timeprovider_.timeStep());
+        VTKOutputter<VTKIOType> io(vtkio, path_, parallel, timeprovider_.timeStep(), VTKFormat::duneType(vtk_format_),
+                                   singleFile(), vtk_magnitude_);
         forEach.apply(io);
+        io.finish();
 
         // write all data
       }
@@ -209,12 +419,17 @@ protected:
     const std::string path_, datapref_;
     const bool parallel_;
     const int step_;
-    Gnu(const double time, std::string path, bool parallel, int step, std::string datapref)
+    const bool binary_;
+    GnuplotCache& cache_;
+    Gnu(const double time, std::string path, bool parallel, int step, std::string datapref, const bool binary,
+        GnuplotCache& cache)
       : time_(time)
       , path_(path)
       , datapref_(datapref)
       , parallel_(parallel)
-      , step_(step) {}
+      , step_(step)
+      , binary_(binary)
+      , cache_(cache) {}
     // write to gnuplot file format
     template <class DFType>
     void visit(const DFType* func) const {
@@ -240,44 +455,97 @@ protected:
       // generate filename
       //					std::string name = genFilename( path_, datapref_, step_ );
       std::string name = genFilename(path_, datapref_, 0);
-      name += "_" + func->name() + ".gnu";
-      const bool first = (time_ > 0.0);
-      std::ios_base::openmode mode = first ? std::ios_base::app : std::ios_base::out;
-      std::ofstream gnuout(name.c_str(), mode);
-
-      if (first) {
-        gnuout << "#";
-        for (int i = 0; i < dimDomain; ++i)
-          gnuout << "x_" << i << " ";
-        for (int i = 0; i < dimRange; ++i)
-          gnuout << "f_" << i << " ";
-        gnuout << "time"
-               << "\n";
-      }
+      name += "_" + func->name() + (binary_ ? ".bin" : ".gnu");
+      std::ofstream& gnuout = file(name, dimDomain, dimRange);
+
+      const int order = func->space().order();
+      std::vector<double>& coordinates = cache_.coordinates[order];
+      const bool fill_coordinates = coordinates.empty();
+      std::string buffer;
+      double record[dimDomain + dimRange + 1];
+      record[dimDomain + dimRange] = time_;
+      size_t point = 0;
       // start iteration
       IteratorType endit = func->space().end();
       for (IteratorType it = func->space().begin(); it != endit; ++it) {
-        CachingQuadrature<GridPartType, 0> quad(*it, func->space().order());
+        CachingQuadrature<GridPartType, 0> quad(*it, order);
         LocalFunctionType lf = func->localFunction(*it);
-        for (size_t i = 0; i < quad.nop(); ++i) {
+        for (size_t i = 0; i < quad.nop(); ++i, ++point) {
+          if (fill_coordinates) {
+            const DomainType x = it->geometry().global(quad.point(i));
+            for (int d = 0; d < dimDomain; ++d)
+              coordinates.push_back(x[d]);
+          }
           RangeType u;
-          DomainType x = it->geometry().global(quad.point(i));
           lf.evaluate(quad[i], u);
-          for (int i = 0; i < dimDomain; ++i)
-            gnuout << x[i] << " ";
-          for (int i = 0; i < dimRange; ++i)
-            gnuout << u[i] << " ";
-          gnuout << time_ << "\n";
+          for (int d = 0; d < dimDomain; ++d)
+            record[d] = coordinates[point * dimDomain + d];
+          for (int r = 0; r < dimRange; ++r)
+            record[dimDomain + r] = u[r];
+          if (binary_)
+            buffer.append(reinterpret_cast<const char*>(record), sizeof(record));
+          else
+            format(buffer, record, dimDomain + dimRange + 1);
+        }
+        if (buffer.size() > (1 << 20)) {
+          gnuout.write(buffer.data(), buffer.size());
+          buffer.clear();
         }
       }
-      gnuout << "\n\n";
+      // gnuplot separates data blocks by two blank lines
+      if (!binary_)
+        buffer += "\n\n";
+      gnuout.write(buffer.data(), buffer.size());
+      gnuout.flush();
+    }
+
+  private:
+    //! %.10g is plenty for plotting and a lot cheaper than operator<<
+    static void format(std::string& buffer, const double* values, const int count) {
+      char number[32];
+      for (int i = 0; i < count; ++i) {
+        const int length = snprintf(number, sizeof(number), i + 1 < count ? "%.10g " : "%.10g\n", values[i]);
+        buffer.append(number, length);
+      }
+    }
+
+    //! the files stay open for the whole run, the first write at time 0 truncates them
+    std::ofstream& file(const std::string& name, const int dimDomain, const int dimRange) const {
+      boost::shared_ptr<std::ofstream>& out = cache_.files[name];
+      if (out)
+        return *out;
+      const bool append = (time_ > 0.0);
+      std::ios_base::openmode mode = append ? std::ios_base::app : std::ios_base::out;
+      if (binary_)
+        mode |= std::ios_base::binary;
+      out.reset(new std::ofstream(name.c_str(), mode));
+      if (!*out)
+        DUNE_THROW(IOError, "could not open " << name);
+      if (binary_) {
+        Logger().Info() << boost::format("gnuplot: plot '%s' binary format='%%%ddouble'\n") % name %
+                               (dimDomain + dimRange + 1);
+      } else if (!append) {
+        *out << "#";
+        for (int i = 0; i < dimDomain; ++i)
+          *out << "x_" << i << " ";
+        for (int i = 0; i < dimRange; ++i)
+          *out << "f_" << i << " ";
+        *out << "time"
+             << "\n";
+      }
+      return *out;
     }
   };
 
   void writeGnuPlotOutput(const double time) const {
     const bool parallel = (grid_.comm().size() > 1);
+    const int sequence = DofManager<GridType>::instance(grid_).sequence();
+    if (sequence != gnuplot_cache_.sequence) {
+      gnuplot_cache_.coordinates.clear();
+      gnuplot_cache_.sequence = sequence;
+    }
     ForEachValue<OutputTupleType> forEach(data_);
-    Gnu io(time, path_, parallel, timeprovider_.timeStep(), datapref_);
+    Gnu io(time, path_, parallel, timeprovider_.timeStep(), datapref_, gnuplot_binary_, gnuplot_cache_);
     forEach.apply(io);
   }
 };
@@ -38,6 +38,7 @@ public:
 
 protected:
   using BaseType::comm_;
+  using BaseType::time_;
   using BaseType::cfl_;
   using BaseType::dt_;
   using BaseType::dtEstimate_;
@@ -47,24 +48,44 @@ protected:
   static const int substep_count_ = SchemeParameterType::numberOfSteps_;
   const double startTime_;
   const double endTime_;
-  const SchemeParameterType& theta_scheme_parameter_;
+  SchemeParameterType& theta_scheme_parameter_;
   int current_substep_;
   ExecutionTimer step_timer_;
   Stuff::MovingAverage avg_time_per_step_;
   long total_stepcount_estimate_;
+  const bool adaptive_;
+  double dt_min_;
+  double dt_max_;
+  //! step size requested for the next full step, negative if there is none
+  double pending_dt_;
+  //! state at the beginning of the current full step, needed to redo rejected steps
+  double step_begin_time_;
+  int step_begin_timestep_;
+  int step_begin_substep_;
 
 public:
-  FractionalTimeProvider(const SchemeParameterType& theta_scheme_parameter, const CommProvider& comm)
+  FractionalTimeProvider(SchemeParameterType& theta_scheme_parameter, const CommProvider& comm)
     : BaseType(comm)
     , startTime_(Parameter::getValue("fem.timeprovider.starttime", // this is somewhat duplicated in empty basetype ctor
                                      (double)0.0))
     , endTime_(Parameter::getValidValue("fem.timeprovider.endtime", (double)1.0, ValidateGreater<double>(startTime_)))
     , theta_scheme_parameter_(theta_scheme_parameter)
     , current_substep_(-1)
-    , total_stepcount_estimate_(-1) {
+    , total_stepcount_estimate_(-1)
+    , adaptive_(Parameter::getValue("fem.timeprovider.adaptive", false))
+    , dt_min_(0.0)
+    , dt_max_(0.0)
+    , pending_dt_(-1.0)
+    , step_begin_time_(0.0)
+    , step_begin_timestep_(0)
+    , step_begin_substep_(0) {
     dt_ = Parameter::getValidValue("fem.timeprovider.dt", (double)0.1,
                                    // assure  dt is in (0,endTime_ - startTime_]
                                    ValidateInterval<double, false, true>(0.0, endTime_ - startTime_));
+    dt_min_ = Parameter::getValidValue("fem.timeprovider.dt_min", dt_ / 100.0,
+                                       ValidateInterval<double, false, true>(0.0, dt_));
+    dt_max_ = Parameter::getValidValue("fem.timeprovider.dt_max", endTime_ - startTime_,
+                                       ValidateInterval<double, true, true>(dt_, endTime_ - startTime_));
     BaseType::init(dt_);
     total_stepcount_estimate_ = long(std::ceil((endTime_ - startTime_) / dt_));
     step_timer_.start();
@@ -130,7 +151,86 @@ public:
 
   StepZeroGuard stepZeroGuard(const double dt) { return StepZeroGuard(dt, *this); }
 
+  //! true if the full step size is controlled by the scheme's temporal error estimate
+  bool adaptive() const { return adaptive_; }
+
+  double minDeltaT() const { return dt_min_; }
+  double maxDeltaT() const { return dt_max_; }
+
+  /** \brief marks the beginning of a full time step
+      applies a step size change requested via proposeDeltaT and remembers the current state for rejectStep
+    **/
+  void beginStep() {
+    if (pending_dt_ > 0.0) {
+      setDeltaT(pending_dt_);
+      pending_dt_ = -1.0;
+    }
+    if (adaptive_) {
+      // do not step over the interval end
+      const double t_n = stepBeginTime();
+      if (t_n < endTime_ && t_n + dt_ > endTime_)
+        setDeltaT(endTime_ - t_n);
+    }
+    step_begin_time_ = time_;
+    step_begin_timestep_ = timeStep_;
+    step_begin_substep_ = current_substep_;
+  }
+
+  //! request delta_t (clamped to [dt_min,dt_max]) for the next full step, it's applied in the next beginStep call
+  void proposeDeltaT(const double delta_t) { pending_dt_ = Stuff::clamp(delta_t, dt_min_, dt_max_); }
+
+  //! discard all sub-steps taken since beginStep and restart the step with delta_t (clamped to [dt_min,dt_max])
+  void rejectStep(const double delta_t) {
+    time_ = step_begin_time_;
+    timeStep_ = step_begin_timestep_;
+    current_substep_ = step_begin_substep_;
+    setDeltaT(Stuff::clamp(delta_t, dt_min_, dt_max_));
+  }
+
+  //! everything needed to continue exactly where a previous run stopped, see ThetaSchemeBase::writeCheckpoint
+  template <class Archive>
+  void writeState(Archive& archive) const {
+    archive.scalar(time_);
+    archive.scalar(timeStep_);
+    archive.scalar(current_substep_);
+    archive.scalar(dt_);
+    archive.scalar(pending_dt_);
+    for (int i = 0; i < substep_count_; ++i)
+      archive.scalar(theta_scheme_parameter_.step_sizes_[i]);
+  }
+
+  template <class Archive>
+  void readState(Archive& archive) {
+    archive.scalar(time_);
+    archive.scalar(timeStep_);
+    archive.scalar(current_substep_);
+    archive.scalar(dt_);
+    archive.scalar(pending_dt_);
+    // restored verbatim instead of rescaled, rescaling is not exact in floating point
+    for (int i = 0; i < substep_count_; ++i)
+      archive.scalar(theta_scheme_parameter_.step_sizes_[i]);
+    total_stepcount_estimate_ = timeStep_ + long(std::ceil((endTime_ - time_) / dt_));
+  }
+
 protected:
+  //! equivalent of t_{n} for the full step whose first sub-step ends at subTime()
+  double stepBeginTime() const { return subTime() - theta_scheme_parameter_.step_sizes_[0]; }
+
+  /** set t_{n+1} - t_{n} and rescale the sub-steps accordingly
+      since the base time is not necessarily t_{n} (it depends on the sub-step we're in) it is moved such that the
+      current full step still starts at t_{n}
+    **/
+  void setDeltaT(const double delta_t) {
+    const double t_n = stepBeginTime();
+    dt_ = delta_t;
+    theta_scheme_parameter_.rescale(delta_t);
+    double offset = 0.0;
+    for (int i = 0; i < current_substep_; ++i)
+      offset += theta_scheme_parameter_.step_sizes_[i];
+    time_ = t_n + theta_scheme_parameter_.step_sizes_[0] - offset;
+    total_stepcount_estimate_ = timeStep_ + long(std::ceil((endTime_ - t_n) / dt_));
+  }
+
   void next(const double timeStep) {
     assert(timeStep > 0);
     current_substep_ = 0;
@@ -0,0 +1,117 @@
+#ifndef GRIDCACHE_HH
+#define GRIDCACHE_HH
+
+#include <dune/navier/nestediteration.hh>
+#include <dune/grid/io/file/dgfparser/dgfparser.hh>
+#include <dune/common/mpihelper.hh>
+#include <dune/stuff/logging.hh>
+#include <dune/stuff/profiler.hh>
+#include <boost/scoped_ptr.hpp>
+#include <boost/format.hpp>
+#include <string>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief keeps the macro grid of the last run alive for the next one
+  * Grid refinement studies request increasing refine levels on the same DGF file and the other studies request the
+  * same level over and over, so the DGF file is only parsed again when file or communicator change, or when a
+  * coarser level than the cached one is requested. A finer level is reached by refining the cached grid further.
+  * Grid parts and spaces are not kept, they depend on the scheme traits of the individual run and are cheap to set up
+  * compared to parsing and refining.
+  * The solution of the last run can be kept alongside for nested iteration, it is dropped with the grid.
+  * The cache is keyed on the communicator handle. MPI may hand out the handle of a freed communicator again, so
+  * whoever frees a communicator a cached grid may live on has to call release() before. Call clear() before MPI is
+  * finalized.
+  */
+template <class GridType>
+class GridCache {
+  typedef typename MPIHelper::MPICommunicator MPICommunicatorType;
+
+public:
+  GridCache()
+    : refine_level_(0)
+    , hits_(0) {}
+
+  GridType& get(const std::string& filename, const int refine_level,
+                MPICommunicatorType comm = MPIHelper::getCommunicator()) {
+    Stuff::Profiler::ScopedTiming grid_time("grid_setup");
+    if (!grid_ || filename != filename_ || !sameCommunicator(comm) || refine_level < refine_level_) {
+      grid_.reset();
+      solution_.clear();
+      grid_.reset(new GridPtr<GridType>(filename, comm));
+      filename_ = filename;
+      comm_ = comm;
+      refine_level_ = 0;
+    } else
+      ++hits_;
+    if (refine_level > refine_level_) {
+      (*grid_)->globalRefine(refine_level - refine_level_);
+      refine_level_ = refine_level;
+    }
+    Logger().Dbg() << boost::format("grid cache: %s at level %d (%d re-uses)\n") % filename_ % refine_level_ % hits_;
+    return **grid_;
+  }
+
+  void clear() {
+    solution_.clear();
+    grid_.reset();
+  }
+
+  //! drop the grid if it lives on \a comm, which is about to be freed
+  void release(MPICommunicatorType comm) {
+    if (grid_ && sameCommunicator(comm))
+      clear();
+  }
+
+  NestedIterationState<GridType>& solution() { return solution_; }
+
+private:
+  bool sameCommunicator(const MPICommunicatorType& comm) const {
+#if HAVE_MPI
+    return comm == comm_;
+#else
+    return true;
+#endif
+  }
+
+  boost::scoped_ptr<GridPtr<GridType>> grid_;
+  std::string filename_;
+  MPICommunicatorType comm_;
+  int refine_level_;
+  long hits_;
+  NestedIterationState<GridType> solution_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // GRIDCACHE_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
@@ -0,0 +1,127 @@
+#ifndef NESTEDITERATION_HH
+#define NESTEDITERATION_HH
+
+#include <dune/fem/quadrature/cachingquadrature.hh>
+#include <dune/fem/operator/1order/localmassmatrix.hh>
+#include <map>
+#include <vector>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief solution of a run stored elementwise by global id, so it survives refinement of the grid
+  * prolong() evaluates the stored local functions on the first ancestor of each leaf element that has data and
+  * L2-projects them onto the leaf, i.e. it is exact for nested DG spaces. Slots allow keeping several functions,
+  * the schemes use 0 for the velocity and 1 for the pressure.
+  */
+template <class GridType>
+class NestedIterationState {
+  typedef typename GridType::Traits::GlobalIdSet GlobalIdSetType;
+  typedef typename GlobalIdSetType::IdType IdType;
+  typedef typename GridType::template Codim<0>::EntityPointer EntityPointerType;
+  typedef typename GridType::template Codim<0>::Geometry::LocalCoordinate LocalCoordinateType;
+  typedef std::map<IdType, std::vector<double>> LocalDofMap;
+
+public:
+  bool empty() const { return slots_.empty(); }
+
+  void clear() { slots_.clear(); }
+
+  template <class DiscreteFunctionType>
+  void store(const DiscreteFunctionType& function, const size_t slot) {
+    typedef typename DiscreteFunctionType::DiscreteFunctionSpaceType::IteratorType IteratorType;
+    const GlobalIdSetType& ids = function.space().gridPart().grid().globalIdSet();
+    if (slots_.size() <= slot)
+      slots_.resize(slot + 1);
+    LocalDofMap& dofs = slots_[slot];
+    dofs.clear();
+    const IteratorType end = function.space().end();
+    for (IteratorType it = function.space().begin(); it != end; ++it) {
+      const typename DiscreteFunctionType::LocalFunctionType lf = function.localFunction(*it);
+      std::vector<double>& local = dofs[ids.id(*it)];
+      local.resize(lf.numDofs());
+      for (size_t i = 0; i < local.size(); ++i)
+        local[i] = lf[i];
+    }
+  }
+
+  //! \return false if some leaf element has no ancestor with data, \a function is garbage then
+  template <class DiscreteFunctionType>
+  bool prolong(DiscreteFunctionType& function, const size_t slot) const {
+    typedef typename DiscreteFunctionType::DiscreteFunctionSpaceType SpaceType;
+    typedef typename SpaceType::IteratorType IteratorType;
+    typedef CachingQuadrature<typename SpaceType::GridPartType, 0> QuadratureType;
+    if (slot >= slots_.size())
+      return false;
+    const LocalDofMap& dofs = slots_[slot];
+    const SpaceType& space = function.space();
+    const GlobalIdSetType& ids = space.gridPart().grid().globalIdSet();
+    LocalMassMatrix<SpaceType, QuadratureType> mass_matrix(space, 2 * space.order());
+    function.clear();
+    const IteratorType end = space.end();
+    for (IteratorType it = space.begin(); it != end; ++it) {
+      // the chain of fathers up to the element the coarse solution lives on
+      std::vector<EntityPointerType> chain(1, EntityPointerType(*it));
+      typename LocalDofMap::const_iterator coarse = dofs.find(ids.id(*it));
+      while (coarse == dofs.end() && chain.back()->hasFather()) {
+        chain.push_back(chain.back()->father());
+        coarse = dofs.find(ids.id(*chain.back()));
+      }
+      if (coarse == dofs.end())
+        return false;
+      const typename SpaceType::BaseFunctionSetType coarse_basis = space.baseFunctionSet(*chain.back());
+      typename DiscreteFunctionType::LocalFunctionType lf = function.localFunction(*it);
+      const QuadratureType quad(*it, 2 * space.order());
+      for (size_t qp = 0; qp < quad.nop(); ++qp) {
+        LocalCoordinateType x = quad.point(qp);
+        for (size_t level = 0; level + 1 < chain.size(); ++level)
+          x = chain[level]->geometryInFather().global(x);
+        typename SpaceType::RangeType value(0.0), phi;
+        for (size_t i = 0; i < coarse->second.size(); ++i) {
+          coarse_basis.evaluate(i, x, phi);
+          value.axpy(coarse->second[i], phi);
+        }
+        value *= quad.weight(qp) * it->geometry().integrationElement(quad.point(qp));
+        lf.axpy(quad[qp], value);
+      }
+      mass_matrix.applyInverse(*it, lf);
+    }
+    return true;
+  }
+
+private:
+  std::vector<LocalDofMap> slots_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // NESTEDITERATION_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
@@ -0,0 +1,158 @@
+#ifndef OUTPUTSCHEDULER_HH
+#define OUTPUTSCHEDULER_HH
+
+#include <dune/navier/parameterlist.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/stuff/parametercontainer.hh>
+#include <dune/stuff/logging.hh>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cmath>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief decides which calls of ThetaSchemeBase::writeData actually write, selected by output_policy
+  * - always: every call (the default, as before)
+  * - step: like Dune::DataWriter::willWrite, every fem.io.savestep time units and/or every fem.io.savecount-th
+  *   (fractional) time step, whichever is positive
+  * - times: at the first call at or after each of the absolute times in output_times ("0.5;1;2.5")
+  * - change: whenever the relative updates accumulated since the last output exceed output_change_threshold
+  * - none: never, for benchmarking
+  * The initial data is written by all policies except none.
+  */
+class OutputScheduler {
+public:
+  enum Policy {
+    always,
+    step,
+    times,
+    change,
+    none
+  };
+
+  OutputScheduler(const double start_time)
+    : policy_(policyFromString(Parameters().getParam("output_policy", std::string("always"))))
+    , save_step_(Parameters().getParam("fem.io.savestep", -1.0))
+    , save_count_(Parameters().getParam("fem.io.savecount", -1))
+    , change_threshold_(Parameters().getParam("output_change_threshold", 0.1, Dune::ValidateGreater<double>(0.0)))
+    , next_save_time_(start_time)
+    , next_time_index_(0)
+    , accumulated_change_(0.0)
+    , calls_(0) {
+    if (policy_ == times) {
+      output_times_ = parameterList<double>("output_times");
+      std::sort(output_times_.begin(), output_times_.end());
+    }
+    if (policy_ == step && save_step_ <= 0.0 && save_count_ <= 0)
+      Logger().Err() << "output_policy step without positive fem.io.savestep or fem.io.savecount writes nothing"
+                     << std::endl;
+  }
+
+  /** \return true if the call at \a time / \a time_step should write
+    * \a relative_change is the norm of the latest update relative to the solution, only used by the change policy
+    */
+  bool due(const double time, const int time_step, const double relative_change) {
+    const bool initial = calls_++ == 0;
+    switch (policy_) {
+      case none:
+        return false;
+      case always:
+        return true;
+      case step: {
+        bool write = initial || (save_count_ > 0 && time_step % save_count_ == 0);
+        if (save_step_ > 0.0 && time >= next_save_time_ - 1e-10 * save_step_) {
+          write = true;
+          // skip the output times we stepped over, dt might be larger than savestep
+          next_save_time_ += save_step_ * std::max(1.0, std::ceil((time - next_save_time_) / save_step_ + 1e-10));
+        }
+        return write;
+      }
+      case times: {
+        bool write = initial;
+        while (next_time_index_ < output_times_.size() && time >= output_times_[next_time_index_] - 1e-10) {
+          write = true;
+          ++next_time_index_;
+        }
+        return write;
+      }
+      case change:
+        accumulated_change_ += relative_change;
+        if (!initial && accumulated_change_ < change_threshold_)
+          return false;
+        accumulated_change_ = 0.0;
+        return true;
+    }
+    return true;
+  }
+
+  //! the state due() depends on, for checkpoints. Archive is CheckpointOutput or CheckpointInput.
+  template <class Archive>
+  void checkpoint(Archive& archive) {
+    archive.check(int(policy_), "output_policy");
+    archive.scalar(next_save_time_);
+    archive.scalar(next_time_index_);
+    archive.scalar(accumulated_change_);
+    archive.scalar(calls_);
+  }
+
+  //! true for output_policy none, nothing may be written then
+  bool disabled() const { return policy_ == none; }
+
+  //! false if due() depends on the relative change, so callers can skip computing it
+  bool needsChange() const { return policy_ == change; }
+
+private:
+  static Policy policyFromString(const std::string& name) {
+    const char* names[] = {"always", "step", "times", "change", "none"};
+    for (int i = 0; i < 5; ++i)
+      if (name == names[i])
+        return Policy(i);
+    DUNE_THROW(InvalidStateException, "unknown output_policy " << name);
+  }
+
+  const Policy policy_;
+  const double save_step_;
+  const int save_count_;
+  const double change_threshold_;
+  double next_save_time_;
+  std::vector<double> output_times_;
+  size_t next_time_index_;
+  double accumulated_change_;
+  long calls_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // OUTPUTSCHEDULER_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
@@ -0,0 +1,68 @@
+#ifndef PARAMETERLIST_HH
+#define PARAMETERLIST_HH
+
+#include <dune/common/exceptions.hh>
+#include <dune/stuff/parametercontainer.hh>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <vector>
+#include <string>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief entries of the list valued parameter \a name, converted to T
+  * Entries are separated by any of "; \t,", empty entries are skipped, so "1, 2;3" and "1 2 3" are the same list.
+  * A parameter that does not exist is parsed from \a default_list, an entry that does not convert throws an
+  * InvalidStateException.
+  */
+template <class T>
+std::vector<T> parameterList(const std::string& name, const std::string& default_list = std::string()) {
+  std::vector<T> ret;
+  const std::string list =
+      boost::trim_copy(Dune::Parameter::exists(name) ? Parameters().getParam(name, default_list) : default_list);
+  std::vector<std::string> entries;
+  boost::split(entries, list, boost::is_any_of("; \t,"), boost::token_compress_on);
+  try {
+    for (size_t i = 0; i < entries.size(); ++i)
+      if (!entries[i].empty())
+        ret.push_back(boost::lexical_cast<T>(entries[i]));
+  }
+  catch (boost::bad_lexical_cast&) {
+    DUNE_THROW(InvalidStateException, "cannot parse " << name << ": " << list);
+  }
+  return ret;
+}
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // PARAMETERLIST_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
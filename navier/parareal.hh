@@ -0,0 +1,188 @@
+#ifndef PARAREAL_HH
+#define PARAREAL_HH
+
+#include <dune/navier/runinfoexchange.hh>
+#include <dune/stuff/parametercontainer.hh>
+#include <dune/stuff/logging.hh>
+#include <dune/stuff/profiler.hh>
+#include <dune/common/exceptions.hh>
+#include <boost/format.hpp>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief parareal iteration over time slices of [fem.timeprovider.starttime, fem.timeprovider.endtime]
+  * The accurate (fine) scheme runs on all slices concurrently, slice j on rank j % size of the world communicator,
+  * and a cheap coarse scheme propagates the corrections sequentially:
+  * \f$U^k_{j+1} = G(U^k_j) + F(U^{k-1}_j) - G(U^{k-1}_j)\f$.
+  * The coarse sweep is done redundantly on every rank, that's cheaper than broadcasting its results.
+  * Fine propagations always write their output, to a per slice datafileprefix, so that the last one of every slice
+  * is kept without another fine sweep after convergence. Slices still being corrected in the last iteration were
+  * thus written from the state before that iteration's correction, which differs by less than parareal_tolerance.
+  * RunnerType must solve the spatial problem on its own (i.e. on a grid that lives on a single rank).
+  */
+template <class RunnerType, class CommunicatorType>
+class Parareal {
+  typedef std::vector<double> StateType;
+
+public:
+  Parareal(RunnerType& runner, const CommunicatorType& world)
+    : runner_(runner)
+    , world_(world)
+    , start_time_(Parameters().getParam("fem.timeprovider.starttime", 0.0))
+    , end_time_(Parameters().getParam("fem.timeprovider.endtime", 1.0))
+    , fine_dt_(Parameters().getParam("fem.timeprovider.dt", 0.1))
+    , slices_(Parameters().getParam("parareal_slices", world.size(), Dune::ValidateNotLess<int>(1)))
+    , slice_length_((end_time_ - start_time_) / slices_)
+    , coarse_dt_(Parameters().getParam("parareal_coarse_dt", slice_length_, Dune::ValidateGreater<double>(0.0)))
+    , coarse_scheme_(Parameters().getParam("parareal_coarse_scheme", 2))
+    , max_iterations_(Parameters().getParam("parareal_iterations", slices_, Dune::ValidateNotLess<int>(1)))
+    , tolerance_(Parameters().getParam("parareal_tolerance", 1e-6, Dune::ValidateGreater<double>(0.0))) {
+    if (world_.size() == 1)
+      Logger().Err() << "parareal on a single rank is just a slower sequential run" << std::endl;
+  }
+
+  ~Parareal() {
+    Parameters().setParam("fem.timeprovider.starttime", start_time_);
+    Parameters().setParam("fem.timeprovider.endtime", end_time_);
+    Parameters().setParam("fem.timeprovider.dt", fine_dt_);
+  }
+
+  Stuff::RunInfoTimeMap run(const int fine_scheme) {
+    // U[j] is the state at the start of slice j, empty means exact initial data
+    std::vector<StateType> U(slices_ + 1), coarse(slices_), fine(slices_);
+    // run infos of the last fine propagation of each local slice
+    std::vector<Stuff::RunInfoTimeMap> fine_infos(slices_);
+    const std::string prefix = Parameters().getParam("fem.io.datafileprefix", std::string("solu_"));
+    for (int j = 0; j < slices_; ++j) {
+      coarse[j] = U[j];
+      propagate(coarse_scheme_, coarse_dt_, j, coarse[j], false);
+      U[j + 1] = coarse[j];
+    }
+    const size_t dofs = U[1].size();
+
+    // after as many iterations as there are slices the fine solution has been propagated through all of them
+    for (int k = 1; k <= std::min(max_iterations_, slices_); ++k) {
+      Stuff::Profiler::ScopedTiming parareal_time("parareal_iteration");
+      // slices before k-1 started from converged data in the previous iteration and don't change anymore
+      const int first = k - 1;
+      std::vector<double> buffer((slices_ - first) * dofs, 0.0);
+      std::string error;
+      for (int j = first; j < slices_ && error.empty(); ++j) {
+        if (j % world_.size() != world_.rank())
+          continue;
+        fine[j] = U[j];
+        Parameters().setParam("fem.io.datafileprefix", (boost::format("%sslice%d_") % prefix % j).str());
+        try {
+          fine_infos[j] = propagate(fine_scheme, fine_dt_, j, fine[j], true);
+        }
+        catch (std::exception& e) {
+          error = e.what();
+        }
+        catch (Dune::Exception& e) {
+          error = e.what();
+        }
+        if (error.empty())
+          std::copy(fine[j].begin(), fine[j].end(), buffer.begin() + (j - first) * dofs);
+      }
+      Parameters().setParam("fem.io.datafileprefix", prefix);
+      // all ranks have to agree on giving up before the next collective call
+      int failed = !error.empty();
+      world_.max(&failed, 1);
+      if (failed) {
+        if (!error.empty())
+          Logger().Err() << boost::format("parareal: fine propagation failed on rank %d: %s\n") % world_.rank() %
+                                error;
+        DUNE_THROW(InvalidStateException, "parareal: a fine propagation failed in iteration " << k);
+      }
+      world_.sum(&buffer[0], buffer.size());
+
+      double max_change = 0.0;
+      for (int j = first; j < slices_; ++j) {
+        fine[j].assign(buffer.begin() + (j - first) * dofs, buffer.begin() + (j - first + 1) * dofs);
+        StateType coarse_new = U[j];
+        propagate(coarse_scheme_, coarse_dt_, j, coarse_new, false);
+        double change = 0.0, norm = 0.0;
+        for (size_t i = 0; i < dofs; ++i) {
+          const double corrected = coarse_new[i] + fine[j][i] - coarse[j][i];
+          change += std::pow(corrected - U[j + 1][i], 2);
+          norm += corrected * corrected;
+          U[j + 1][i] = corrected;
+        }
+        coarse[j].swap(coarse_new);
+        max_change = std::max(max_change, std::sqrt(change / std::max(norm, 1e-20)));
+      }
+      Logger().Info() << boost::format("parareal iteration %d: max relative slice update %e\n") % k % max_change;
+      if (max_change < tolerance_)
+        break;
+    }
+
+    Stuff::RunInfoTimeMap local;
+    for (int j = world_.rank(); j < slices_; j += world_.size())
+      local.insert(fine_infos[j].begin(), fine_infos[j].end());
+    return RunInfoExchange::allMerge(world_, local);
+  }
+
+private:
+  //! run scheme_type on slice j, with dt shrunk such that the slice is an integer multiple of it
+  Stuff::RunInfoTimeMap propagate(const int scheme_type, const double dt, const int slice, StateType& state,
+                                  const bool output) {
+    const double t0 = start_time_ + slice * slice_length_;
+    const double steps = std::ceil(slice_length_ / dt - 1e-10);
+    const double slice_dt = slice_length_ / steps;
+    Parameters().setParam("fem.timeprovider.starttime", t0);
+    // a little slack so roundoff in the time loop does not swallow the last step
+    Parameters().setParam("fem.timeprovider.endtime", t0 + slice_length_ + 1e-8 * slice_dt);
+    Parameters().setParam("fem.timeprovider.dt", slice_dt);
+    return runner_.run(scheme_type, state, output);
+  }
+
+  RunnerType& runner_;
+  const CommunicatorType& world_;
+  const double start_time_;
+  const double end_time_;
+  const double fine_dt_;
+  const int slices_;
+  const double slice_length_;
+  const double coarse_dt_;
+  const int coarse_scheme_;
+  const int max_iterations_;
+  const double tolerance_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // PARAREAL_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
@@ -0,0 +1,262 @@
+#ifndef PROBES_HH
+#define PROBES_HH
+
+#include <dune/navier/parameterlist.hh>
+#include <dune/grid/utility/hierarchicsearch.hh>
+#include <dune/grid/common/exceptions.hh>
+#include <dune/fem/space/common/dofmanager.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/stuff/parametercontainer.hh>
+#include <dune/stuff/logging.hh>
+#include <dune/stuff/profiler.hh>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/shared_ptr.hpp>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief time series of velocity and pressure at a few fixed points
+  * The points come from probe_points ("x,y;x,y;..") and probe_lines ("x0,y0,x1,y1,n;..", n equidistant points from
+  * x0 to x1 each). Every point is located once with a HierarchicSearch and its element and local coordinate are
+  * cached until the grid changes. Only the rank owning the (interior) element evaluates, the values are summed up and
+  * rank 0 appends one row per sample to <datadir>/<datafileprefix>probes_run<run_key>.csv, or, with probe_format
+  * binary, to probes_run<run_key>.bin as raw doubles. Probes outside the grid are reported once and stay nan.
+  * The file is started afresh unless \a append is set, as for a run resumed from a checkpoint.
+  */
+template <class GridPartType>
+class Probes {
+  typedef typename GridPartType::GridType GridType;
+  typedef typename GridType::template Codim<0>::EntityPointer EntityPointerType;
+  typedef typename GridType::template Codim<0>::Geometry::GlobalCoordinate GlobalCoordinateType;
+  typedef typename GridType::template Codim<0>::Geometry::LocalCoordinate LocalCoordinateType;
+  static const int dim = GridType::dimension;
+
+  struct Location {
+    Location(const EntityPointerType& _entity, const LocalCoordinateType& _local)
+      : entity(_entity)
+      , local(_local) {}
+    EntityPointerType entity;
+    LocalCoordinateType local;
+  };
+
+public:
+  //! true if the parameter file asks for any probes
+  static bool enabled() { return Dune::Parameter::exists("probe_points") || Dune::Parameter::exists("probe_lines"); }
+
+  Probes(const GridPartType& gridPart, const bool append)
+    : gridPart_(gridPart)
+    , dof_manager_(DofManager<GridType>::instance(gridPart.grid()))
+    , interval_(Parameters().getParam("probe_interval", 1, Dune::ValidateNotLess<int>(1)))
+    , binary_(Parameters().getParam("probe_format", std::string("csv")) == "binary")
+    , sequence_(-1)
+    , rows_(append ? 1 : 0) {
+    const std::vector<double> points = parse("probe_points", dim);
+    for (size_t i = 0; i < points.size(); i += dim)
+      points_.push_back(coordinate(&points[i]));
+    const std::vector<double> lines = parse("probe_lines", 2 * dim + 1);
+    for (size_t i = 0; i < lines.size(); i += 2 * dim + 1) {
+      const GlobalCoordinateType begin = coordinate(&lines[i]);
+      const GlobalCoordinateType end = coordinate(&lines[i + dim]);
+      const int count = std::max(2, int(lines[i + 2 * dim]));
+      for (int j = 0; j < count; ++j) {
+        GlobalCoordinateType x = begin;
+        x.axpy(double(j) / (count - 1), end - begin);
+        points_.push_back(x);
+      }
+    }
+    if (gridPart_.grid().comm().rank() == 0)
+      open(append);
+  }
+
+  /** \brief evaluates every probe_interval-th call (all ranks have to call this)
+    * \a velocity and \a pressure are discrete functions on gridPart
+    */
+  template <class VelocityType, class PressureType>
+  void sample(const int step, const double time, const VelocityType& velocity, const PressureType& pressure) {
+    if (step % interval_ != 0 || points_.empty())
+      return;
+    Stuff::Profiler::ScopedTiming probe_time("probes");
+    if (sequence_ != dof_manager_.sequence())
+      locate();
+    const int velocity_components = VelocityType::RangeType::dimension;
+    const int components = velocity_components + PressureType::RangeType::dimension;
+    // zero on all but the owning rank, so the sum is the owner's value
+    std::vector<double> values(points_.size() * components, 0.0);
+    for (size_t i = 0; i < locations_.size(); ++i) {
+      if (!locations_[i])
+        continue;
+      evaluate(velocity, *locations_[i], &values[i * components]);
+      evaluate(pressure, *locations_[i], &values[i * components + velocity_components]);
+    }
+    gridPart_.grid().comm().sum(&values[0], values.size());
+    for (size_t i = 0; i < points_.size(); ++i)
+      if (!found_[i])
+        std::fill(values.begin() + i * components, values.begin() + (i + 1) * components, std::nan(""));
+    if (gridPart_.grid().comm().rank() == 0)
+      write(time, values, velocity_components, components);
+  }
+
+private:
+  //! flat list of numbers from \a name, a multiple of \a tuple
+  static std::vector<double> parse(const std::string& name, const size_t tuple) {
+    const std::vector<double> ret = parameterList<double>(name);
+    if (ret.size() % tuple != 0)
+      DUNE_THROW(InvalidStateException, name << " needs groups of " << tuple << " numbers");
+    return ret;
+  }
+
+  static GlobalCoordinateType coordinate(const double* values) {
+    GlobalCoordinateType x;
+    for (int d = 0; d < dim; ++d)
+      x[d] = values[d];
+    return x;
+  }
+
+  //! the element and local coordinate of every probe on this rank, ghosts are left to their owners
+  void locate() {
+    typedef typename GridType::LeafIndexSet IndexSetType;
+    HierarchicSearch<GridType, IndexSetType> search(gridPart_.grid(), gridPart_.grid().leafIndexSet());
+    locations_.assign(points_.size(), boost::shared_ptr<Location>());
+    std::vector<int> found(points_.size(), 0);
+    for (size_t i = 0; i < points_.size(); ++i) {
+      try {
+        const EntityPointerType entity = search.findEntity(points_[i]);
+        if (entity->partitionType() != InteriorEntity)
+          continue;
+        locations_[i].reset(new Location(entity, entity->geometry().local(points_[i])));
+        found[i] = 1;
+      }
+      catch (Dune::GridError&) {
+        // not on this rank
+      }
+    }
+    gridPart_.grid().comm().sum(&found[0], found.size());
+    // a point on an element boundary may be found by more than one rank, the lowest rank keeps it
+    std::vector<int> owner(points_.size(), gridPart_.grid().comm().size());
+    for (size_t i = 0; i < points_.size(); ++i)
+      if (locations_[i])
+        owner[i] = gridPart_.grid().comm().rank();
+    gridPart_.grid().comm().min(&owner[0], owner.size());
+    found_.assign(points_.size(), false);
+    for (size_t i = 0; i < points_.size(); ++i) {
+      if (owner[i] != gridPart_.grid().comm().rank())
+        locations_[i].reset();
+      found_[i] = found[i] > 0;
+      if (!found_[i] && sequence_ < 0 && gridPart_.grid().comm().rank() == 0)
+        Logger().Err() << "probe " << i << " at " << points_[i] << " is outside of the grid" << std::endl;
+    }
+    sequence_ = dof_manager_.sequence();
+  }
+
+  template <class DiscreteFunctionType>
+  static void evaluate(const DiscreteFunctionType& function, const Location& location, double* values) {
+    typename DiscreteFunctionType::RangeType value;
+    function.localFunction(*location.entity).evaluate(location.local, value);
+    for (int r = 0; r < int(DiscreteFunctionType::RangeType::dimension); ++r)
+      values[r] = value[r];
+  }
+
+  void open(const bool append) {
+    const std::string directory = Parameters().getParam("fem.io.datadir", std::string("data"));
+    boost::filesystem::create_directories(directory);
+    const std::string filename = (boost::format("%s/%sprobes_run%d.%s") % directory %
+                                  Parameters().getParam("fem.io.datafileprefix", std::string("solu_")) %
+                                  Parameters().getParam("run_key", 0) % (binary_ ? "bin" : "csv")).str();
+    std::ios_base::openmode mode = append ? std::ios_base::app : std::ios_base::out;
+    if (binary_)
+      mode |= std::ios_base::binary;
+    out_.reset(new std::ofstream(filename.c_str(), mode));
+    if (!*out_)
+      DUNE_THROW(IOError, "could not open " << filename);
+    std::ostringstream locations;
+    for (size_t i = 0; i < points_.size(); ++i)
+      locations << "# probe " << i << ": " << points_[i] << "\n";
+    if (binary_)
+      Logger().Info() << locations.str() << "probes: rows of time, then velocity and pressure of every probe, in "
+                      << filename << std::endl;
+    else if (!append)
+      *out_ << locations.str();
+  }
+
+  void write(const double time, const std::vector<double>& values, const int velocity_components,
+             const int components) {
+    if (binary_) {
+      out_->write(reinterpret_cast<const char*>(&time), sizeof(double));
+      out_->write(reinterpret_cast<const char*>(&values[0]), values.size() * sizeof(double));
+    } else {
+      if (rows_ == 0) {
+        *out_ << "time";
+        for (size_t i = 0; i < points_.size(); ++i) {
+          for (int r = 0; r < velocity_components; ++r)
+            *out_ << ",u" << r << "_" << i;
+          for (int r = velocity_components; r < components; ++r)
+            *out_ << ",p_" << i;
+        }
+        *out_ << "\n";
+      }
+      char number[32];
+      std::string row((boost::format("%.12g") % time).str());
+      for (size_t i = 0; i < values.size(); ++i) {
+        const int length = snprintf(number, sizeof(number), ",%.10g", values[i]);
+        row.append(number, length);
+      }
+      row += "\n";
+      out_->write(row.data(), row.size());
+    }
+    out_->flush();
+    ++rows_;
+  }
+
+  const GridPartType& gridPart_;
+  const DofManager<GridType>& dof_manager_;
+  const int interval_;
+  const bool binary_;
+  std::vector<GlobalCoordinateType> points_;
+  //! NULL where another rank (or nobody) owns the probe
+  std::vector<boost::shared_ptr<Location>> locations_;
+  std::vector<bool> found_;
+  int sequence_;
+  long rows_;
+  boost::shared_ptr<std::ofstream> out_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // PROBES_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
@@ -6,6 +6,7 @@
 #include <dune/stuff/grid.hh>
 #include <dune/stuff/math.hh>
 #include <dune/stuff/parametercontainer.hh>
+#include <dune/navier/runconfig.hh>
 #include "common.hh"
 
 namespace NavierProblems {
@@ -291,7 +292,7 @@ public:
     dune_static_assert(FunctionSpaceImp::dimDomain == 2, "__CLASS__ evaluate not implemented for world dimension");
     const double x = arg[0];
     const double y = arg[1];
-    const double v = Parameters().getParam("viscosity", 1.0);
+    const double v = Dune::NavierStokes::runConfig().viscosity;
     const double F = std::exp(-4 * std::pow(P, 2) * v * time);
     const double C_2x = std::cos(2 * P * x);
     const double C_2y = std::cos(2 * P * y);
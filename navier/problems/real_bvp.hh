@@ -4,6 +4,7 @@
 #include <dune/stuff/functions.hh>
 #include <dune/stuff/timefunction.hh>
 #include <dune/stuff/parametercontainer.hh>
+#include <dune/navier/runconfig.hh>
 #include <dune/oseen/boundarydata.hh>
 #include "common.hh"
 
@@ -61,7 +62,7 @@ public:
     dune_static_assert(dim_ == 3, "__CLASS__ evaluate not implemented for world dimension");
     DomainType normal(0);
     normal[2] = 1;
-    const double gd_factor = time * Parameters().getParam("gd_factor", 1.0);
+    const double gd_factor = time * Dune::NavierStokes::runConfig().gd_factor;
     if (arg[2] > 0.0 && arg[2] < z_max) {
       normal *= 0.0;
     }
@@ -137,7 +138,7 @@ public:
     LocalVectorType center = Stuff::getBarycenterLocal(intersection.intersectionSelfLocal());
     RangeType normal = intersection.unitOuterNormal(center);
     ret = normal;
-    double factor = Parameters().getParam("gd_factor", 1.0) * time;
+    double factor = Dune::NavierStokes::runConfig().gd_factor * time;
     switch (id) {
       case 1: {
         factor = 0;
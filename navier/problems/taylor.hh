@@ -4,6 +4,7 @@
 #include <dune/stuff/functions.hh>
 #include <dune/stuff/timefunction.hh>
 #include <dune/stuff/parametercontainer.hh>
+#include <dune/navier/runconfig.hh>
 #include "common.hh"
 
 namespace NavierProblems {
@@ -85,7 +86,7 @@ template <class DomainType, class RangeType>
 void VelocityEvaluate(const double /*lambda*/, const double time, const DomainType& arg, RangeType& ret) {
   const double x = arg[0];
   const double y = arg[1];
-  const double v = Parameters().getParam("viscosity", 1.0);
+  const double v = Dune::NavierStokes::runConfig().viscosity;
   const double E = std::exp(-2 * std::pow(P, 2) * v * time);
   const double S_x = std::sin(P * x);
   const double S_y = std::sin(P * y);
@@ -254,7 +255,7 @@ public:
     dune_static_assert(FunctionSpaceImp::dimDomain == 2, "__CLASS__ evaluate not implemented for world dimension");
     const double x = arg[0];
     const double y = arg[1];
-    const double v = Parameters().getParam("viscosity", 1.0);
+    const double v = Dune::NavierStokes::runConfig().viscosity;
     const double F = std::exp(-4 * std::pow(P, 2) * v * time);
     const double C_2x = std::cos(2 * P * x);
     const double C_2y = std::cos(2 * P * y);
@@ -4,6 +4,7 @@
 #include <dune/stuff/timefunction.hh>
 #include <dune/stuff/functions.hh>
 #include <dune/stuff/parametercontainer.hh>
+#include <dune/navier/runconfig.hh>
 #include <dune/fem/misc/validator.hh>
 
 namespace Dune {
@@ -234,7 +235,7 @@ public:
   void evaluateTime(const double time, const DomainType& arg, RangeType& ret) const {
     const double x = arg[0];
     const double y = arg[1];
-    const double v = Parameters().getParam("viscosity", 1.0, Dune::ValidateNotLess<double>(0.0));
+    const double v = runConfig().viscosity;
   }
 
 private:
@@ -340,7 +341,7 @@ void VelocityEvaluate(const double /*parameter_a*/, const double /*parameter_d*/
                       const DomainType& arg, RangeType& ret) {
   const double x = arg[0];
   const double y = arg[1];
-  const double v = Parameters().getParam("viscosity", 1.0, Dune::ValidateNotLess<double>(0.0));
+  const double v = runConfig().viscosity;
   const double e_minus_2_t = std::exp(-2 * std::pow(pi_factor, 2) * v * time);
 
   ret[0] = -1 * std::cos(pi_factor * x) * std::sin(pi_factor * y) * e_minus_2_t;
@@ -425,7 +426,7 @@ public:
     dune_static_assert(dim_ == 2, "Pressure_Unsuitable_WorldDim");
     const double x = arg[0];
     const double y = arg[1];
-    const double v = Parameters().getParam("viscosity", 1.0, Dune::ValidateNotLess<double>(0.0));
+    const double v = runConfig().viscosity;
     const double e_minus_4_t = std::exp(-4 * std::pow(pi_factor, 2) * time * v);
 
     ret[0] = -0.25 * (std::cos(2 * pi_factor * x) + std::cos(2 * pi_factor * y)) * e_minus_4_t;
@@ -458,7 +459,7 @@ public:
     dune_static_assert(dim_ == 2, "Pressure_Unsuitable_WorldDim");
     const double x = arg[0];
     const double y = arg[1];
-    const double v = Parameters().getParam("viscosity", 1.0, Dune::ValidateNotLess<double>(0.0));
+    const double v = runConfig().viscosity;
     const double e_minus_4_t = std::exp(-4 * std::pow(pi_factor, 2) * time * v);
 
     ret[0] = 2 * pi_factor * 0.25 * (std::sin(2 * pi_factor * x)) * e_minus_4_t;
@@ -493,7 +494,7 @@ public:
 
     const double x = arg[0];
     const double y = arg[1];
-    const double v = Parameters().getParam("viscosity", 1.0, Dune::ValidateNotLess<double>(0.0));
+    const double v = runConfig().viscosity;
     ;
     const double P = pi_factor;
     const double E = std::exp(-2 * std::pow(P, 2) * v * time);
@@ -535,7 +536,7 @@ public:
     //				dune_static_assert( dim_ == 2  , "DirichletData_Unsuitable_WorldDim");
     const double x = arg[0];
     const double y = arg[1];
-    const double v = Parameters().getParam("viscosity", 1.0, Dune::ValidateNotLess<double>(0.0));
+    const double v = runConfig().viscosity;
     const double P = pi_factor;
     const double E = std::exp(-2 * std::pow(P, 2) * v * time);
     const double F = std::exp(-4 * std::pow(P, 2) * v * time);
@@ -843,7 +844,7 @@ void VelocityEvaluate(const double /*parameter_a*/, const double /*parameter_d*/
                       const DomainType& arg, RangeType& ret) {
   const double x = arg[0];
   const double y = arg[1];
-  const double v = Parameters().getParam("viscosity", 1.0, Dune::ValidateNotLess<double>(0.0));
+  const double v = runConfig().viscosity;
   const double F = std::exp(-8 * std::pow(M_PI, 2) * time);
   const double C1 = std::cos(2 * M_PI * (x + 0.25));
   const double S1 = std::sin(2 * M_PI * (x + 0.25));
@@ -929,7 +930,7 @@ public:
   void evaluateTime(const double time, const DomainType& arg, RangeType& ret) const {
     const double x = arg[0];
     const double y = arg[1];
-    const double v = Parameters().getParam("viscosity", 1.0, Dune::ValidateNotLess<double>(0.0));
+    const double v = runConfig().viscosity;
     const double F = std::exp(-16 * std::pow(M_PI, 2) * time);
     const double C1 = std::cos(4 * M_PI * (x + 0.25));
     const double C2 = std::cos(4 * M_PI * (y + 0.5));
@@ -4,6 +4,7 @@
 #include <dune/stuff/functions.hh>
 #include <dune/stuff/timefunction.hh>
 #include <dune/stuff/parametercontainer.hh>
+#include <dune/navier/runconfig.hh>
 #include "common.hh"
 
 namespace NavierProblems {
@@ -67,7 +68,7 @@ public:
     ret[0] += time;
     ret[1] += 1;
     // conv
-    if (!Parameters().getParam("navier_no_convection", false)) {
+    if (!Dune::NavierStokes::runConfig().navier_no_convection) {
       ret[0] += 2 * std::pow(time, 5.0) * x * y;
       ret[1] += std::pow(time, 5.0) * y * y;
     }
@@ -4,6 +4,7 @@
 #include <dune/stuff/functions.hh>
 #include <dune/stuff/timefunction.hh>
 #include <dune/stuff/parametercontainer.hh>
+#include <dune/navier/runconfig.hh>
 #include "common.hh"
 
 namespace NavierProblems {
@@ -44,7 +45,7 @@ public:
     ret[0] += -1 * time;
     ret[1] += 0;
     // conv
-    if (!Parameters().getParam("navier_no_convection", false)) {
+    if (!Dune::NavierStokes::runConfig().navier_no_convection) {
       assert(false);
       ret[0] += -x;
       ret[1] += -y;
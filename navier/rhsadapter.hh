@@ -8,6 +8,44 @@
 
 namespace Dune {
 namespace NavierStokes {
+
+/** \brief keeps the L2 projections of the analytical force for the last two evaluation times
+  * The force only depends on time, so the \f$f_{k-1}\f$ projection needed in sub-step k is the \f$f_{k}\f$ projection
+  * of sub-step k-1, and all adapters built for one sub-step share both.
+  * Entries are keyed by time only. That is sound because the owner (ThetaScheme) lives for one run: its viscosity
+  * and the grid its space is built on stay fixed for that lifetime. Don't share an instance between schemes.
+  */
+template <class DiscreteVelocityFunctionType>
+class ForceProjectionCache {
+public:
+  ForceProjectionCache(const typename DiscreteVelocityFunctionType::DiscreteFunctionSpaceType& space)
+    : slot_a_("force_projection_a", space)
+    , slot_b_("force_projection_b", space) {
+    valid_[0] = valid_[1] = false;
+  }
+
+  template <class AnalyticalForceType>
+  const DiscreteVelocityFunctionType& get(const double time, const AnalyticalForceType& force) {
+    if (valid_[0] && time_[0] == time)
+      return slot_a_;
+    if (valid_[1] && time_[1] == time)
+      return slot_b_;
+    // replace the invalid or the least recently projected slot
+    const int slot = (!valid_[0] || (valid_[1] && time_[0] < time_[1])) ? 0 : 1;
+    DiscreteVelocityFunctionType& target = slot == 0 ? slot_a_ : slot_b_;
+    Dune::BetterL2Projection::project(time, force, target);
+    time_[slot] = time;
+    valid_[slot] = true;
+    return target;
+  }
+
+private:
+  DiscreteVelocityFunctionType slot_a_;
+  DiscreteVelocityFunctionType slot_b_;
+  double time_[2];
+  bool valid_[2];
+};
+
 namespace OseenStep {
 /** \brief take previous step solution \f$u_{k-1}\f$ and analytical RHS to form function to be passed to either
   StokesStep
@@ -30,16 +68,22 @@ protected:
 
 public:
   typedef DiscreteVelocityFunctionType BaseType;
+  typedef ForceProjectionCache<DiscreteVelocityFunctionType> ForceProjectionCacheType;
+
+protected:
+  ForceProjectionCacheType* force_cache_;
 
+public:
   //! this sginature is used in the first stokes where we have analytical data to derive from
   ForceAdapterFunction(const TimeProviderType& timeProvider, const DiscreteVelocityFunctionType& velocity,
                        const AnalyticalForceType& force, const double reynolds, const ThetaValuesType& theta_values,
-                       int /*polOrd*/ = -1)
+                       int /*polOrd*/ = -1, ForceProjectionCacheType* force_cache = NULL)
     : BaseType("stokes-ana-rhsdapater", velocity.space())
     , timeProvider_(timeProvider)
     , force_(force)
     , reynolds_(reynolds)
-    , theta_values_(theta_values) {
+    , theta_values_(theta_values)
+    , force_cache_(force_cache) {
 
     //						NAVIER_DATA_NAMESPACE
     typedef typename DiscreteVelocityFunctionType::FunctionSpaceType::FunctionSpaceType VelocityFunctionSpaceType;
@@ -68,12 +112,14 @@ public:
   template <class RhsContainerType>
   ForceAdapterFunction(const TimeProviderType& timeProvider, const DiscreteVelocityFunctionType& velocity,
                        const AnalyticalForceType& force, const double reynolds, const ThetaValuesType& theta_values,
-                       const RhsContainerType& rhs_container, int /*polOrd*/ = -1)
+                       const RhsContainerType& rhs_container, int /*polOrd*/ = -1,
+                       ForceProjectionCacheType* force_cache = NULL)
     : BaseType("stokes-ana-rhsdapater", velocity.space())
     , timeProvider_(timeProvider)
     , force_(force)
     , reynolds_(reynolds)
-    , theta_values_(theta_values) {
+    , theta_values_(theta_values)
+    , force_cache_(force_cache) {
     AddCommon(velocity, rhs_container.convection, rhs_container.velocity_laplace, rhs_container.pressure_gradient);
   }
 
@@ -89,11 +135,19 @@ protected:
     this->clear();
 
     DiscreteVelocityFunctionType tmp("rhs-ana-tmp", velocity.space());
-    Dune::BetterL2Projection::project(timeProvider_, force_, tmp);
-    tmp *= (theta_values_[3]);
-    *this += tmp;
-
-    Dune::BetterL2Projection::project(timeProvider_.previousSubTime(), force_, tmp);
+    if (force_cache_) {
+      tmp.assign(force_cache_->get(timeProvider_.subTime(), force_));
+      tmp *= (theta_values_[3]);
+      *this += tmp;
+
+      tmp.assign(force_cache_->get(timeProvider_.previousSubTime(), force_));
+    } else {
+      Dune::BetterL2Projection::project(timeProvider_, force_, tmp);
+      tmp *= (theta_values_[3]);
+      *this += tmp;
+
+      Dune::BetterL2Projection::project(timeProvider_.previousSubTime(), force_, tmp);
+    }
     tmp *= (theta_values_[2]);
     *this += tmp;
 
@@ -0,0 +1,98 @@
+#ifndef RUNCONFIG_HH
+#define RUNCONFIG_HH
+
+#include <dune/stuff/parametercontainer.hh>
+#include <dune/fem/misc/validator.hh>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief typed snapshot of the parameters read while stepping and in the evaluation of the problem data
+  * Parameters().getParam is a string keyed container lookup, which dominated e.g. projections of the Taylor problem
+  * where the viscosity is read for every evaluation point. The snapshot is taken once per run, call refresh() after
+  * changing any of these parameters (singleRun does so before it sets up a scheme).
+  * Parameters only read during setup are still taken from Parameters() directly.
+  */
+struct RunConfig {
+  double viscosity;
+  bool parabolic;
+  bool navier_no_convection;
+  bool calculate_errors;
+  double max_error;
+  bool write_fulltimestep_only;
+  bool rhs_cheat;
+  bool clear_u;
+  bool clear_p;
+  bool silent_stokes;
+  unsigned int oseen_iterations;
+  double rhs_factor;
+  double gd_factor;
+  //! only reported in the RunInfo of every step
+  bool do_bfg;
+  double bfg_tau;
+  int minref;
+  double abs_limit;
+  double inner_abs_limit;
+
+  RunConfig() { refresh(); }
+
+  void refresh() {
+    viscosity = Parameters().getParam("viscosity", 1.0, Dune::ValidateNotLess<double>(0.0));
+    parabolic = Parameters().getParam("parabolic", false);
+    navier_no_convection = Parameters().getParam("navier_no_convection", false);
+    calculate_errors = Parameters().getParam("calculate_errors", true);
+    max_error = Parameters().getParam("max_error", 1e2, Dune::ValidateGreater<double>(0.0));
+    write_fulltimestep_only = Parameters().getParam("write_fulltimestep_only", false);
+    rhs_cheat = Parameters().getParam("rhs_cheat", false);
+    clear_u = Parameters().getParam("clear_u", false);
+    clear_p = Parameters().getParam("clear_p", false);
+    silent_stokes = Parameters().getParam("silent_stokes", true);
+    oseen_iterations = Parameters().getParam("oseen_iterations", (unsigned int)(1));
+    rhs_factor = Parameters().getParam("rhs_factor", 1.0);
+    gd_factor = Parameters().getParam("gd_factor", 1.0);
+    do_bfg = Parameters().getParam("do-bfg", true);
+    bfg_tau = Parameters().getParam("bfg-tau", 0.1);
+    minref = Parameters().getParam("minref", 0, Dune::ValidateNotLess<int>(0));
+    abs_limit = Parameters().getParam("absLimit", 1e-4);
+    inner_abs_limit = Parameters().getParam("inner_absLimit", 1e-4);
+  }
+};
+
+//! the snapshot shared by the whole program
+inline RunConfig& runConfig() {
+  static RunConfig config;
+  return config;
+}
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // RUNCONFIG_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
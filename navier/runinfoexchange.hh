@@ -0,0 +1,251 @@
+#ifndef RUNINFOEXCHANGE_HH
+#define RUNINFOEXCHANGE_HH
+
+#include <dune/stuff/runinfo.hh>
+#include <dune/common/exceptions.hh>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief text serialization of RunInfoTimeMaps so they can be shipped between ranks
+  * only the fields filled in by the schemes in this module are transferred, everything else keeps its default.
+  * Doubles travel as their bit pattern, so nan and inf (e.g. the errors of an aborted run) survive the round trip,
+  * and every read is checked, a malformed string throws an IOError instead of yielding zeros.
+  */
+namespace RunInfoExchange {
+
+inline void checkStream(const std::istream& in) {
+  if (!in)
+    DUNE_THROW(IOError, "malformed RunInfo exchange string");
+}
+
+template <class T>
+void writeValue(std::ostream& out, const T& value) {
+  out << value << ' ';
+}
+
+inline void writeValue(std::ostream& out, const double& value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  out << std::hex << bits << std::dec << ' ';
+}
+
+template <class T>
+void readValue(std::istream& in, T& value) {
+  in >> value;
+  checkStream(in);
+}
+
+inline void readValue(std::istream& in, double& value) {
+  uint64_t bits;
+  in >> std::hex >> bits >> std::dec;
+  checkStream(in);
+  std::memcpy(&value, &bits, sizeof(bits));
+}
+
+inline void writeString(std::ostream& out, const std::string& str) { out << str.size() << ':' << str << ' '; }
+
+inline std::string readString(std::istream& in) {
+  size_t length;
+  char colon;
+  in >> length >> colon;
+  checkStream(in);
+  std::string str(length, ' ');
+  if (length > 0)
+    in.read(&str[0], length);
+  checkStream(in);
+  return str;
+}
+
+template <class T>
+void writeVector(std::ostream& out, const std::vector<T>& vec) {
+  writeValue(out, vec.size());
+  for (size_t i = 0; i < vec.size(); ++i)
+    writeValue(out, vec[i]);
+}
+
+template <class T>
+void readVector(std::istream& in, std::vector<T>& vec) {
+  size_t size;
+  readValue(in, size);
+  vec.resize(size);
+  for (size_t i = 0; i < size; ++i)
+    readValue(in, vec[i]);
+}
+
+inline void write(std::ostream& out, const Stuff::RunInfo& info) {
+  writeVector(out, info.L2Errors);
+  writeVector(out, info.H1Errors);
+  writeValue(out, info.codim0);
+  writeValue(out, info.grid_width);
+  writeValue(out, info.run_time);
+  writeValue(out, info.delta_t);
+  writeValue(out, info.current_time);
+  writeValue(out, info.viscosity);
+  writeValue(out, info.reynolds);
+  writeValue(out, info.c11.first);
+  writeValue(out, info.c11.second);
+  writeValue(out, info.c12.first);
+  writeValue(out, info.c12.second);
+  writeValue(out, info.d11.first);
+  writeValue(out, info.d11.second);
+  writeValue(out, info.d12.first);
+  writeValue(out, info.d12.second);
+  writeValue(out, info.bfg);
+  writeValue(out, info.refine_level);
+  writeValue(out, info.polorder_pressure);
+  writeValue(out, info.polorder_sigma);
+  writeValue(out, info.polorder_velocity);
+  writeValue(out, info.solver_accuracy);
+  writeValue(out, info.inner_solver_accuracy);
+  writeValue(out, info.bfg_tau);
+  writeString(out, info.problemIdentifier);
+  writeString(out, info.algo_id);
+  writeString(out, info.extra_info);
+}
+
+//! the fields in the same order as write
+inline void read(std::istream& in, Stuff::RunInfo& info) {
+  readVector(in, info.L2Errors);
+  readVector(in, info.H1Errors);
+  readValue(in, info.codim0);
+  readValue(in, info.grid_width);
+  readValue(in, info.run_time);
+  readValue(in, info.delta_t);
+  readValue(in, info.current_time);
+  readValue(in, info.viscosity);
+  readValue(in, info.reynolds);
+  readValue(in, info.c11.first);
+  readValue(in, info.c11.second);
+  readValue(in, info.c12.first);
+  readValue(in, info.c12.second);
+  readValue(in, info.d11.first);
+  readValue(in, info.d11.second);
+  readValue(in, info.d12.first);
+  readValue(in, info.d12.second);
+  readValue(in, info.bfg);
+  readValue(in, info.refine_level);
+  readValue(in, info.polorder_pressure);
+  readValue(in, info.polorder_sigma);
+  readValue(in, info.polorder_velocity);
+  readValue(in, info.solver_accuracy);
+  readValue(in, info.inner_solver_accuracy);
+  readValue(in, info.bfg_tau);
+  info.problemIdentifier = readString(in);
+  info.algo_id = readString(in);
+  info.extra_info = readString(in);
+}
+
+inline std::string serialize(const Stuff::RunInfoTimeMap& map) {
+  std::ostringstream out;
+  writeValue(out, map.size());
+  for (Stuff::RunInfoTimeMap::const_iterator it = map.begin(); it != map.end(); ++it) {
+    writeValue(out, it->first);
+    write(out, it->second);
+  }
+  return out.str();
+}
+
+//! adds the entries encoded in \a str to \a map
+inline void deserialize(const std::string& str, Stuff::RunInfoTimeMap& map) {
+  std::istringstream in(str);
+  size_t size;
+  readValue(in, size);
+  for (size_t i = 0; i < size; ++i) {
+    double time;
+    readValue(in, time);
+    read(in, map[time]);
+  }
+}
+
+//! the same for a map of RunInfoTimeMaps, e.g. the results of a whole parameter study
+inline std::string serialize(const Stuff::RunInfoTimeMapMap& map) {
+  std::ostringstream out;
+  writeValue(out, map.size());
+  for (Stuff::RunInfoTimeMapMap::const_iterator it = map.begin(); it != map.end(); ++it) {
+    writeValue(out, it->first);
+    writeString(out, serialize(it->second));
+  }
+  return out.str();
+}
+
+inline void deserialize(const std::string& str, Stuff::RunInfoTimeMapMap& map) {
+  std::istringstream in(str);
+  size_t size;
+  readValue(in, size);
+  for (size_t i = 0; i < size; ++i) {
+    Stuff::RunInfoTimeMapMap::key_type key;
+    readValue(in, key);
+    deserialize(readString(in), map[key]);
+  }
+}
+
+//! every rank gets the strings of all ranks, ordered by rank
+template <class CommunicatorType>
+std::vector<std::string> allGather(const CommunicatorType& comm, const std::string& local) {
+  const int size = comm.size();
+  std::vector<int> lengths(size, 0);
+  lengths[comm.rank()] = local.size();
+  comm.sum(&lengths[0], size);
+  std::vector<int> offsets(size + 1, 0);
+  for (int i = 0; i < size; ++i)
+    offsets[i + 1] = offsets[i] + lengths[i];
+  // sum of zero-padded buffers, the interface offers no gatherv
+  std::vector<unsigned char> buffer(std::max(offsets[size], 1), 0);
+  std::copy(local.begin(), local.end(), buffer.begin() + offsets[comm.rank()]);
+  comm.sum(&buffer[0], buffer.size());
+  std::vector<std::string> ret(size);
+  for (int i = 0; i < size; ++i)
+    ret[i].assign(buffer.begin() + offsets[i], buffer.begin() + offsets[i + 1]);
+  return ret;
+}
+
+//! merge the maps of all ranks, entries for the same key are taken from the highest rank
+template <class CommunicatorType, class MapType>
+MapType allMerge(const CommunicatorType& comm, const MapType& local) {
+  const std::vector<std::string> all = allGather(comm, serialize(local));
+  MapType ret;
+  for (size_t i = 0; i < all.size(); ++i)
+    deserialize(all[i], ret);
+  return ret;
+}
+
+} // namespace RunInfoExchange
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // RUNINFOEXCHANGE_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
@@ -2,6 +2,7 @@
 #define METADATA_HH
 
 #include <dune/navier/thetascheme_base.hh>
+#include <dune/navier/fixedpoint.hh>
 
 namespace Dune {
 namespace NavierStokes {
@@ -29,17 +30,218 @@ public:
   using BaseType::viscosity_;
   using BaseType::reynolds_;
 
+protected:
+  typedef typename Traits::DiscreteOseenFunctionWrapperType DiscreteOseenFunctionWrapperType;
+  typedef typename BaseType::DiscreteVelocityFunctionType DiscreteVelocityFunctionType;
+
+  //! buffers and controller settings only needed with adaptive time stepping
+  struct AdaptiveState {
+    AdaptiveState(typename Traits::DiscreteOseenFunctionSpaceWrapperType& space_wrapper,
+                  typename Traits::GridPartType& gridPart,
+                  const typename DiscreteVelocityFunctionType::DiscreteFunctionSpaceType& velocity_space)
+      : step_begin_current("step_begin_current", space_wrapper, gridPart)
+      , step_begin_last("step_begin_last", space_wrapper, gridPart)
+      , step_begin_previous("step_begin_previous", space_wrapper, gridPart)
+      , previous_velocity("previous_step_velocity", velocity_space)
+      , scratch("estimator_scratch", velocity_space)
+      , previous_dt(-1.0)
+      , tolerance(Parameters().getParam("adaptive_dt_tolerance", 1e-3, Dune::ValidateGreater<double>(0.0)))
+      , safety(Parameters().getParam("adaptive_dt_safety", 0.9, Dune::ValidateGreater<double>(0.0)))
+      , max_growth(Parameters().getParam("adaptive_dt_max_growth", 2.0, Dune::ValidateNotLess<double>(1.0)))
+      , max_shrink(Parameters().getParam("adaptive_dt_max_shrink", 0.2, Dune::ValidateGreater<double>(0.0))) {}
+    //! solution at t_{n}, restored on step rejection
+    DiscreteOseenFunctionWrapperType step_begin_current;
+    DiscreteOseenFunctionWrapperType step_begin_last;
+    //! only used if previousFunctions_ is allocated
+    DiscreteOseenFunctionWrapperType step_begin_previous;
+    //! velocity at t_{n-1}, -1 as previous_dt marks it as not yet available
+    DiscreteVelocityFunctionType previous_velocity;
+    DiscreteVelocityFunctionType scratch;
+    double previous_dt;
+    const double tolerance;
+    const double safety;
+    const double max_growth;
+    const double max_shrink;
+  };
+  boost::scoped_ptr<AdaptiveState> adaptive_state_;
+  //! per scheme, the force it caches depends on viscosity_ and the grid of this run
+  ForceProjectionCache<DiscreteVelocityFunctionType> force_cache_;
+
+  //! -1 disables the predictor, otherwise order of the extrapolation in time used as initial guess
+  const int predictor_order_;
+  //! number of time levels available in current/previous/older functions
+  int predictor_history_;
+  /** solution at t_{k-2}, only allocated for the predictor and the multistep schemes
+    * lastFunctions_ can't be used for this, substep() leaves it a copy of the current solution
+    */
+  boost::scoped_ptr<DiscreteOseenFunctionWrapperType> previousFunctions_;
+  //! solution at t_{k-3}, only allocated for the quadratic predictor
+  boost::scoped_ptr<DiscreteOseenFunctionWrapperType> olderFunctions_;
+
+  const unsigned int fixed_point_iterations_;
+  const double fixed_point_tolerance_;
+  //! only allocated with more than one fixed point iteration
+  boost::scoped_ptr<AndersonAcceleration<DiscreteVelocityFunctionType>> anderson_;
+
+  //! buffers of the BDF2/IMEX schemes
+  struct MultistepState {
+    MultistepState(const typename DiscreteVelocityFunctionType::DiscreteFunctionSpaceType& velocity_space)
+      : start_velocity("multistep_start_velocity", velocity_space)
+      , extrapolation("multistep_extrapolation", velocity_space) {}
+    //! u^{*}, the part of the discrete time derivative that moves to the rhs
+    DiscreteVelocityFunctionType start_velocity;
+    //! second order extrapolation of u_{n+1} used for the convection
+    DiscreteVelocityFunctionType extrapolation;
+    //! effective weights of the current step, adapter functions keep a reference
+    typename Traits::ThetaSchemeDescriptionType::ThetaValueArray thetas;
+  };
+  boost::scoped_ptr<MultistepState> multistep_state_;
+  //! dt of the last accepted step
+  double previous_dt_;
+  //! number of accepted full time steps
+  int steps_done_;
+
 public:
   ThetaScheme(typename Traits::GridPartType gridPart, const typename Traits::ThetaSchemeDescriptionType& scheme_params,
               typename BaseType::CommunicatorType comm = typename BaseType::CommunicatorType())
-    : BaseType(gridPart, scheme_params, comm) {}
+    : BaseType(gridPart, scheme_params, comm)
+    , force_cache_(currentFunctions_.discreteVelocity().space())
+    , predictor_order_(Parameters().getParam("predictor_order", -1, Dune::ValidateInterval<int, true, true>(-1, 2)))
+    , predictor_history_(1)
+    , fixed_point_iterations_(runConfig().oseen_iterations)
+    , fixed_point_tolerance_(
+          Parameters().getParam("oseen_iteration_tolerance", 1e-6, Dune::ValidateGreater<double>(0.0)))
+    , previous_dt_(-1.0)
+    , steps_done_(0) {
+    assert(fixed_point_iterations_ > 0);
+    if (timeprovider_.adaptive())
+      adaptive_state_.reset(
+          new AdaptiveState(functionSpaceWrapper_, gridPart_, currentFunctions_.discreteVelocity().space()));
+    if (predictor_order_ > 0 || scheme_params_.isMultistep())
+      previousFunctions_.reset(new DiscreteOseenFunctionWrapperType("previous", functionSpaceWrapper_, gridPart_));
+    if (predictor_order_ == 2)
+      olderFunctions_.reset(new DiscreteOseenFunctionWrapperType("older", functionSpaceWrapper_, gridPart_));
+    if (fixed_point_iterations_ > 1)
+      anderson_.reset(new AndersonAcceleration<DiscreteVelocityFunctionType>(
+          currentFunctions_.discreteVelocity().space(),
+          Parameters().getParam("anderson_depth", 0, Dune::ValidateNotLess<int>(0))));
+    if (scheme_params_.isMultistep())
+      multistep_state_.reset(new MultistepState(currentFunctions_.discreteVelocity().space()));
+  }
+
+  virtual void checkpointData(CheckpointOutput& out) { checkpointState(out); }
+  virtual void checkpointData(CheckpointInput& in) { checkpointState(in); }
+
+  //! time level history of the predictor, BDF2 and the step size control, everything else is rebuilt every step
+  template <class Archive>
+  void checkpointState(Archive& archive) {
+    archive.scalar(predictor_history_);
+    archive.scalar(previous_dt_);
+    archive.scalar(steps_done_);
+    archive.check(bool(previousFunctions_), "time level history");
+    if (previousFunctions_) {
+      archive.function(previousFunctions_->discreteVelocity());
+      archive.function(previousFunctions_->discretePressure());
+    }
+    archive.check(bool(olderFunctions_), "predictor order");
+    if (olderFunctions_) {
+      archive.function(olderFunctions_->discreteVelocity());
+      archive.function(olderFunctions_->discretePressure());
+    }
+    archive.check(bool(adaptive_state_), "time step control");
+    if (adaptive_state_) {
+      archive.function(adaptive_state_->previous_velocity);
+      archive.scalar(adaptive_state_->previous_dt);
+    }
+  }
+
+  //! the sub-steps of a rejected step are taken again, see adaptive_timestep
+  virtual bool substepsMayBeRejected() const { return bool(adaptive_state_); }
 
   virtual Stuff::RunInfo full_timestep() {
     Stuff::Profiler::ScopedTiming fullstep_time("full_step");
+    // beginStep applies pending dt changes, so this is the step size of the last accepted step
+    previous_dt_ = timeprovider_.deltaT();
+    timeprovider_.beginStep();
+    const Stuff::RunInfo info = adaptive_state_ ? adaptive_timestep() : fixed_timestep();
+    ++steps_done_;
+    return info;
+  }
+
+  Stuff::RunInfo adaptive_timestep() {
+    AdaptiveState& state = *adaptive_state_;
+    state.step_begin_current.assign(currentFunctions_);
+    state.step_begin_last.assign(lastFunctions_);
+    if (previousFunctions_)
+      state.step_begin_previous.assign(*previousFunctions_);
+    const double tolerance = state.tolerance;
+    for (;;) {
+      Stuff::RunInfo info = fixed_timestep();
+      const double dt = timeprovider_.deltaT();
+      if (state.previous_dt < 0.0) {
+        // no history yet to estimate the error from, keep the initial dt
+        acceptStep(dt, dt);
+        return info;
+      }
+      const double error = extrapolationDefect(dt);
+      // the indicator behaves like O(dt^2), hence the square root
+      const double factor = error > 0.0 ? Stuff::clamp(state.safety * std::sqrt(tolerance / error), state.max_shrink,
+                                                       state.max_growth)
+                                        : state.max_growth;
+      const bool at_min_dt = dt <= timeprovider_.minDeltaT() * (1.0 + 1e-10);
+      if (error <= tolerance || at_min_dt) {
+        if (error > tolerance)
+          Logger().Err() << boost::format("accepting step with error indicator %e > %e at minimal dt %e\n") % error %
+                                tolerance % dt;
+        acceptStep(dt, dt * factor);
+        return info;
+      }
+      Logger().Info() << boost::format("rejected step at t = %f (dt = %e, error indicator %e), retry with dt = %e\n") %
+                             timeprovider_.subTime() % dt % error % (dt * factor);
+      currentFunctions_.assign(state.step_begin_current);
+      nextFunctions_.assign(state.step_begin_current);
+      lastFunctions_.assign(state.step_begin_last);
+      if (previousFunctions_)
+        previousFunctions_->assign(state.step_begin_previous);
+      // olderFunctions_ was already rotated during the rejected step
+      predictor_history_ = std::min(predictor_history_, 2);
+      timeprovider_.rejectStep(dt * factor);
+    }
+  }
+
+  /** \brief relative difference of u^{n+1} to its linear extrapolation from u^{n} and u^{n-1}
+      This is a heuristic error indicator, not an estimate of the local error of the theta scheme: it measures the
+      curvature of the solution in time, \f$\frac{1}{2}\delta t(\delta t + \delta t_{n-1}) \|u_{tt}\|\f$, which
+      is what limits the accuracy of smooth solutions, at the cost of one vector operation instead of a second solve
+      (embedded scheme or step doubling). Steps are therefore controlled by how fast the flow changes, and the
+      tolerance has no direct relation to the actual time discretization error.
+    **/
+  double extrapolationDefect(const double dt) const {
+    const AdaptiveState& state = *adaptive_state_;
+    DiscreteVelocityFunctionType& prediction = adaptive_state_->scratch;
+    // prediction = u^{n} + (dt / dt_prev)(u^{n} - u^{n-1})
+    prediction.assign(state.step_begin_current.discreteVelocity());
+    prediction -= state.previous_velocity;
+    prediction *= dt / state.previous_dt;
+    prediction += state.step_begin_current.discreteVelocity();
+    prediction -= nextFunctions_.discreteVelocity();
+    Dune::L2Norm<typename Traits::GridPartType> l2_norm(gridPart_);
+    const double norm = std::max(l2_norm.norm(nextFunctions_.discreteVelocity()), 1e-10);
+    return l2_norm.norm(prediction) / norm;
+  }
+
+  void acceptStep(const double dt, const double next_dt) {
+    adaptive_state_->previous_velocity.assign(adaptive_state_->step_begin_current.discreteVelocity());
+    adaptive_state_->previous_dt = dt;
+    timeprovider_.proposeDeltaT(next_dt);
+  }
+
+  Stuff::RunInfo fixed_timestep() {
     Stuff::RunInfo info;
     for (int i = 0; i < Traits::substep_count; ++i) {
       const double dt_k = scheme_params_.step_sizes_[i];
-      substep(dt_k, scheme_params_.thetas_[i]);
+      predict(i);
+      substep(dt_k, multistep_state_ ? prepare_multistep() : scheme_params_.thetas_[i]);
       if (i != Traits::substep_count - 1)
         // the last step increase is done after one call level up
         BaseType::nextStep(i, info);
@@ -47,14 +249,105 @@ public:
     return info;
   }
 
+  /** \brief seeds nextFunctions_ with the extrapolation of the previous time levels to the end of sub-step \a step
+      uses Lagrange extrapolation through t_{k-1}, t_{k-2}, t_{k-3} with the actual sub-step sizes, the order is
+      reduced while not enough time levels are available
+    **/
+  void predict(const int step) {
+    const int order = std::min(predictor_order_, predictor_history_ - 1);
+    if (order >= 0) {
+      const int N = Traits::substep_count;
+      const double h = scheme_params_.step_sizes_[step];
+      const double h1 = scheme_params_.step_sizes_[(step + N - 1) % N];
+      const double h2 = scheme_params_.step_sizes_[(step + N - 2) % N];
+      const Dune::array<double, 3> nodes = {{0.0, -h1, -h1 - h2}};
+      Dune::array<double, 3> weights = {{1.0, 0.0, 0.0}};
+      for (int i = 0; i <= order; ++i) {
+        weights[i] = 1.0;
+        for (int j = 0; j <= order; ++j) {
+          if (j != i)
+            weights[i] *= (h - nodes[j]) / (nodes[i] - nodes[j]);
+        }
+      }
+      const Dune::array<const DiscreteOseenFunctionWrapperType*, 3> levels = {
+          {&currentFunctions_, previousFunctions_.get(), olderFunctions_.get()}};
+      linearCombination(nextFunctions_.discreteVelocity(), levels, weights, order, VelocityTag());
+      linearCombination(nextFunctions_.discretePressure(), levels, weights, order, PressureTag());
+      Logger().Dbg() << boost::format("predictor of order %d, weights %e %e %e\n") % order % weights[0] % weights[1] %
+                            weights[2];
+    }
+  }
+
+  //! shifts the time levels of the predictor and the multistep schemes before currentFunctions_ is overwritten
+  void rotateHistory() {
+    if (olderFunctions_)
+      olderFunctions_->assign(*previousFunctions_);
+    if (previousFunctions_)
+      previousFunctions_->assign(currentFunctions_);
+    predictor_history_ = std::min(predictor_history_ + 1, 3);
+  }
+
+  struct VelocityTag {};
+  struct PressureTag {};
+
+  static const DiscreteVelocityFunctionType& component(const DiscreteOseenFunctionWrapperType& functions, VelocityTag) {
+    return functions.discreteVelocity();
+  }
+
+  static const typename BaseType::DiscretePressureFunctionType&
+  component(const DiscreteOseenFunctionWrapperType& functions, PressureTag) {
+    return functions.discretePressure();
+  }
+
+  template <class DiscreteFunctionType, class Tag>
+  static void linearCombination(DiscreteFunctionType& target,
+                                const Dune::array<const DiscreteOseenFunctionWrapperType*, 3>& levels,
+                                const Dune::array<double, 3>& weights, const int order, Tag tag) {
+    target.assign(component(*levels[0], tag));
+    target *= weights[0];
+    for (int i = 1; i <= order; ++i)
+      target.addScaled(component(*levels[i], tag), weights[i]);
+  }
+
+  /** \brief weights and start values of variable step BDF2 for \f$\omega = \delta t_n / \delta t_{n-1}\f$
+    * \f$\frac{1+2\omega}{1+\omega}u_{n+1} - (1+\omega)u_n + \frac{\omega^2}{1+\omega}u_{n-1} = \delta t_n (f_{n+1} -
+    * A(u_{n+1}))\f$ is divided by the leading coefficient, the first step falls back to backward euler
+    **/
+  const typename Traits::ThetaSchemeDescriptionType::ThetaValueArray& prepare_multistep() {
+    MultistepState& state = *multistep_state_;
+    const DiscreteVelocityFunctionType& u_n = currentFunctions_.discreteVelocity();
+    const DiscreteVelocityFunctionType& u_n_1 = previousFunctions_->discreteVelocity();
+    state.start_velocity.assign(u_n);
+    state.extrapolation.assign(u_n);
+    if (steps_done_ < 1) {
+      Stuff::fill_entirely(state.thetas, 1.0);
+      state.thetas[1] = state.thetas[2] = 0.0;
+      return state.thetas;
+    }
+    const double omega = timeprovider_.deltaT() / previous_dt_;
+    const double theta = (1.0 + omega) / (1.0 + 2.0 * omega);
+    state.thetas[0] = state.thetas[3] = theta;
+    state.thetas[1] = state.thetas[2] = 0.0;
+    // u^{*} = (1+omega)^2/(1+2omega) u_n - omega^2/(1+2omega) u_{n-1}
+    state.start_velocity *= (1.0 + omega) * theta;
+    state.start_velocity.addScaled(u_n_1, -omega * omega / (1.0 + 2.0 * omega));
+    // u_{n+1} ~ (1+omega) u_n - omega u_{n-1}
+    state.extrapolation *= 1.0 + omega;
+    state.extrapolation.addScaled(u_n_1, -omega);
+    return state.thetas;
+  }
+
   boost::shared_ptr<typename Traits::OseenForceAdapterFunctionType>
   prepare_rhs(const typename Traits::ThetaSchemeDescriptionType::ThetaValueArray& theta_values) {
     const bool first_step = timeprovider_.timeStep() <= 2;
     const typename Traits::AnalyticalForceType force(timeprovider_, currentFunctions_.discreteVelocity().space(),
                                                      viscosity_, 0.0 /*stokes alpha*/);
-    const bool do_cheat = Parameters().getParam("rhs_cheat", false);
+    const bool do_cheat = runConfig().rhs_cheat;
+    // multistep schemes put u^{*} in place of u_n into the discrete time derivative
+    const DiscreteVelocityFunctionType& velocity =
+        multistep_state_ ? multistep_state_->start_velocity : currentFunctions_.discreteVelocity();
 
-    if (!Parameters().getParam("parabolic", false) &&
+    if (!runConfig().parabolic &&
         (scheme_params_.algo_id == Traits::ThetaSchemeDescriptionType::scheme_names[3] /*CN*/)) {
       // reconstruct the prev convection term
       auto beta = currentFunctions_.discreteVelocity();
@@ -69,18 +362,20 @@ public:
     null_f *= 0.0;
     boost::shared_ptr<typename Traits::OseenForceAdapterFunctionType> ptr_oseenForceVanilla(
         first_step // in our very first step no previous computed data is avail. in rhs_container
-            ? new typename Traits::OseenForceAdapterFunctionType(timeprovider_, exactSolution_.discreteVelocity(),
-                                                                 force, reynolds_, theta_values)
-            : new typename Traits::OseenForceAdapterFunctionType(timeprovider_, currentFunctions_.discreteVelocity(),
-                                                                 force, reynolds_, theta_values, rhsDatacontainer_));
+            ? new typename Traits::OseenForceAdapterFunctionType(timeprovider_,
+                                                                 BaseType::projectedExactSolution().discreteVelocity(),
+                                                                 force, reynolds_, theta_values, -1, &force_cache_)
+            : new typename Traits::OseenForceAdapterFunctionType(timeprovider_, velocity, force, reynolds_,
+                                                                 theta_values, rhsDatacontainer_, -1, &force_cache_));
     //					if ( do_cheat )
     BaseType::cheatRHS();
     boost::shared_ptr<typename Traits::OseenForceAdapterFunctionType> ptr_oseenForce(
         first_step // in our very first step no previous computed data is avail. in rhs_container
-            ? new typename Traits::OseenForceAdapterFunctionType(timeprovider_, exactSolution_.discreteVelocity(),
-                                                                 force, reynolds_, theta_values)
-            : new typename Traits::OseenForceAdapterFunctionType(timeprovider_, currentFunctions_.discreteVelocity(),
-                                                                 force, reynolds_, theta_values, rhsDatacontainer_));
+            ? new typename Traits::OseenForceAdapterFunctionType(timeprovider_,
+                                                                 BaseType::projectedExactSolution().discreteVelocity(),
+                                                                 force, reynolds_, theta_values, -1, &force_cache_)
+            : new typename Traits::OseenForceAdapterFunctionType(timeprovider_, velocity, force, reynolds_,
+                                                                 theta_values, rhsDatacontainer_, -1, &force_cache_));
     typename BaseType::L2ErrorType::Errors errors_rhs =
         l2Error_.get(static_cast<typename Traits::StokesForceAdapterType::BaseType>(*ptr_oseenForce),
                      static_cast<typename Traits::StokesForceAdapterType::BaseType>(*ptr_oseenForceVanilla));
@@ -91,40 +386,44 @@ public:
     return do_cheat ? ptr_oseenForce : ptr_oseenForceVanilla;
   }
 
-  typename Traits::OseenPassType
-  prepare_pass(const typename Traits::ThetaSchemeDescriptionType::ThetaValueArray& theta_values) {
-    const auto rhs = prepare_rhs(theta_values);
-    const double dt_n = timeprovider_.deltaT();
-    const bool do_convection_disc =
-        !(Parameters().getParam("navier_no_convection", false) || Parameters().getParam("parabolic", false));
-    auto beta = currentFunctions_.discreteVelocity(); //=u^n = bwe linearization
+  /** \brief initial linearization velocity of the convection term
+    * \return false if convection is not discretized at all, beta is cleared in that case
+    **/
+  bool prepare_beta(DiscreteVelocityFunctionType& beta) const {
+    const bool do_convection_disc = convection_enabled();
+    if (multistep_state_) {
+      // BDF2 linearizes around the extrapolation, IMEX moves the convection into the rhs
+      if (do_convection_disc && !convection_is_explicit()) {
+        beta.assign(multistep_state_->extrapolation);
+        return true;
+      }
+      beta.clear();
+      return false;
+    }
+    beta.assign(currentFunctions_.discreteVelocity()); //=u^n = bwe linearization
     if (do_convection_disc && (scheme_params_.algo_id == Traits::ThetaSchemeDescriptionType::scheme_names[3] /*CN*/)) {
       // linearization: 1.5u^n-0.5u^{n-1}
       beta *= 1.5;
-      auto dummy = lastFunctions_.discreteVelocity();
-      dummy *= 0.5;
-      beta -= dummy;
+      beta.addScaled(lastFunctions_.discreteVelocity(), -0.5);
     } else if (!do_convection_disc)
       beta.clear();
-    Dune::StabilizationCoefficients stab_coeff = Dune::StabilizationCoefficients::getDefaultStabilizationCoefficients();
-    stab_coeff.FactorFromParams("C11");
-    stab_coeff.FactorFromParams("C12");
-    stab_coeff.FactorFromParams("D11");
-    stab_coeff.FactorFromParams("D12");
-    typename Traits::AnalyticalDirichletDataType oseenDirichletData(timeprovider_, functionSpaceWrapper_,
-                                                                    theta_values[0], 1 - theta_values[0]);
-    typename Traits::OseenModelType oseenModel(
-        stab_coeff, *rhs, oseenDirichletData, theta_values[0] / reynolds_, /*viscosity*/
-        1.0f / dt_n,                                                       /*alpha*/
-        //											do_convection_disc ? theta_values[0] * dt_n : 0.0, /*convection_scale_factor*/
-        theta_values[0], /*convection_scale_factor*/
-        theta_values[0]  /*pressure_gradient_scale_factor*/
-        );
+    return do_convection_disc;
+  }
 
-    return typename Traits::OseenPassType(oseenModel, gridPart_, functionSpaceWrapper_, beta /*beta*/,
-                                          do_convection_disc /*do_oseen_disc*/);
+  static bool convection_enabled() {
+    return !(runConfig().navier_no_convection || runConfig().parabolic);
   }
 
+  //! IMEX treats the convection explicitly
+  bool convection_is_explicit() const {
+    return scheme_params_.algo_id == Traits::ThetaSchemeDescriptionType::scheme_names[7];
+  }
+
+  /** \brief one sub-step, optionally iterating the linearization to a fixed point
+    * rhs and model are assembled once, each iteration only sets up a new pass for the updated beta. With
+    * "oseen_iterations" > 1 the loop stops once the relative velocity update drops below
+    * "oseen_iteration_tolerance", "anderson_depth" > 0 enables Anderson acceleration of the iterates.
+    **/
   void substep(const double /*dt_k*/,
                const typename Traits::ThetaSchemeDescriptionType::ThetaValueArray& theta_values) {
     {
@@ -134,18 +433,58 @@ public:
           Stuff::boundaryIntegral(oseenDirichletData, BaseType::currentFunctions().discreteVelocity().space());
       Logger().Dbg() << boost::format("discrete Boundary integral: %e\n") % boundaryInt;
     }
-    auto oseenPass = prepare_pass(theta_values);
-    if (timeprovider_.timeStep() <= 2)
-      oseenPass.printInfo();
-    if (Parameters().getParam("silent_stokes", true))
-      Logger().Info().Suspend(Stuff::Logging::LogStream::default_suspend_priority + 10);
-    if (Parameters().getParam("clear_u", false))
+    const auto rhs = prepare_rhs(theta_values);
+    DiscreteVelocityFunctionType beta("beta", currentFunctions_.discreteVelocity().space());
+    const bool do_convection_disc = prepare_beta(beta);
+    if (convection_is_explicit() && convection_enabled()) {
+      // rhs -= theta_0 (u~ \cdot \nabla) u~ with the extrapolation u~ of u_{n+1}
+      Dune::BruteForceReconstruction<typename Traits::OseenModelType>::getConvection(
+          multistep_state_->extrapolation, rhsDatacontainer_.velocity_gradient, rhsDatacontainer_.convection);
+      rhs->addScaled(rhsDatacontainer_.convection, -theta_values[0]);
+    }
+    Dune::StabilizationCoefficients stab_coeff = Dune::StabilizationCoefficients::getDefaultStabilizationCoefficients();
+    stab_coeff.FactorFromParams("C11");
+    stab_coeff.FactorFromParams("C12");
+    stab_coeff.FactorFromParams("D11");
+    stab_coeff.FactorFromParams("D12");
+    typename Traits::AnalyticalDirichletDataType oseenDirichletData(timeprovider_, functionSpaceWrapper_,
+                                                                    theta_values[0], 1 - theta_values[0]);
+    const double dt_n = timeprovider_.deltaT();
+    typename Traits::OseenModelType oseenModel(stab_coeff, *rhs, oseenDirichletData, theta_values[0] / reynolds_,
+                                               1.0f / dt_n,     /*alpha*/
+                                               theta_values[0], /*convection_scale_factor*/
+                                               theta_values[0]  /*pressure_gradient_scale_factor*/
+                                               );
+
+    if (runConfig().clear_u)
       nextFunctions_.discreteVelocity().clear();
-    if (Parameters().getParam("clear_p", false))
+    if (runConfig().clear_p)
       nextFunctions_.discretePressure().clear();
-    oseenPass.apply(currentFunctions_, nextFunctions_, &rhsDatacontainer_);
-    Logger().Info().Resume(Stuff::Logging::LogStream::default_suspend_priority + 10);
+    // without convection the problem is linear, nothing to iterate
+    const unsigned int iterations = do_convection_disc ? fixed_point_iterations_ : 1;
+    if (anderson_)
+      anderson_->reset();
+    for (unsigned int k = 0;; ++k) {
+      typename Traits::OseenPassType oseenPass(oseenModel, gridPart_, functionSpaceWrapper_, beta /*beta*/,
+                                               do_convection_disc /*do_oseen_disc*/);
+      if (k == 0 && timeprovider_.timeStep() <= 2)
+        oseenPass.printInfo();
+      if (runConfig().silent_stokes)
+        Logger().Info().Suspend(Stuff::Logging::LogStream::default_suspend_priority + 10);
+      oseenPass.apply(currentFunctions_, nextFunctions_, &rhsDatacontainer_);
+      Logger().Info().Resume(Stuff::Logging::LogStream::default_suspend_priority + 10);
+      if (k + 1 >= iterations)
+        break;
+      // beta <- next iterate
+      const double update = anderson_->update(beta, nextFunctions_.discreteVelocity());
+      const double norm = std::max(
+          std::sqrt(nextFunctions_.discreteVelocity().scalarProductDofs(nextFunctions_.discreteVelocity())), 1e-10);
+      Logger().Info() << boost::format("fixed point iteration %d: relative update %e\n") % (k + 1) % (update / norm);
+      if (update / norm <= fixed_point_tolerance_)
+        break;
+    }
     BaseType::setUpdateFunctions();
+    rotateHistory();
     currentFunctions_.assign(nextFunctions_);
   }
 };
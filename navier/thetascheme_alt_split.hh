@@ -75,7 +75,7 @@ public:
              const typename Traits::ThetaSchemeDescriptionType::ThetaValueArray& /*theta_values*/) const {
     DiscretizationWeights discretization_weights(BaseType::d_t_, viscosity_);
 
-    if (Parameters().getParam("silent_stokes", true))
+    if (runConfig().silent_stokes)
       Logger().Suspend(Stuff::Logging::LogStream::default_suspend_priority + 1);
 
     const bool first_stokes_step = timeprovider_.timeStep() <= 1;
@@ -93,7 +93,7 @@ public:
     L2ErrorType l2Error(gridPart_);
 
     // CHEAT (projecting the anaylitcal evals into the container filled by last pass
-    const bool do_cheat = Parameters().getParam("rhs_cheat", false) && !first_stokes_step;
+    const bool do_cheat = runConfig().rhs_cheat && !first_stokes_step;
     dummyFunctions_.discreteVelocity().assign(currentFunctions_.discreteVelocity());
     //					if ( do_cheat ) //do cheat rhs assembly unconditionally, below we'll choose according to do_cheat which
     //rhs to put into the model
@@ -118,7 +118,7 @@ public:
       //																			dummyFunctions_.discreteVelocity() );
       //						std::cerr << "BLAH " << errors_convection.str();
 
-      currentFunctions_.discreteVelocity().assign(exactSolution_.discreteVelocity());
+      currentFunctions_.discreteVelocity().assign(BaseType::projectedExactSolution().discreteVelocity());
     } // END CHEAT
 
     boost::scoped_ptr<typename Traits::StokesForceAdapterType> ptr_stokesForce(
@@ -165,7 +165,7 @@ public:
     BaseType::setUpdateFunctions();
     Stuff::RunInfo info;
     stokesPass.getRuninfo(info);
-    if (Parameters().getParam("silent_stokes", true))
+    if (runConfig().silent_stokes)
       Logger().Resume(Stuff::Logging::LogStream::default_suspend_priority + 1);
     return info;
   }
@@ -179,7 +179,7 @@ public:
                                                      viscosity_, 0.0 /*stokes alpha*/);
 
     // CHEAT (projecting the anaylitcal evals into the container filled by last pass
-    if (Parameters().getParam("rhs_cheat", false)) {
+    if (runConfig().rhs_cheat) {
       typedef typename BaseType::DiscreteVelocityFunctionType::FunctionSpaceType::FunctionSpaceType
       VelocityFunctionSpaceType;
       VelocityFunctionSpaceType continousVelocitySpace_;
@@ -195,14 +195,14 @@ public:
       VelocityLaplace velocity_laplace(timeprovider_, continousVelocitySpace_);
       Dune::BetterL2Projection::project(timeprovider_.previousSubTime(), velocity_laplace,
                                         rhsDatacontainer_.velocity_laplace);
-      currentFunctions_.discreteVelocity().assign(exactSolution_.discreteVelocity());
+      currentFunctions_.discreteVelocity().assign(BaseType::projectedExactSolution().discreteVelocity());
     } // END CHEAT
 
     typename Traits::NonlinearForceAdapterType nonlinearForce(timeprovider_, currentFunctions_.discreteVelocity(),
                                                               force, discretization_weights, rhsDatacontainer_);
 
     rhsFunctions_.discreteVelocity().assign(nonlinearForce);
-    unsigned int oseen_iterations = Parameters().getParam("oseen_iterations", (unsigned int)(1));
+    unsigned int oseen_iterations = runConfig().oseen_iterations;
     assert(oseen_iterations > 0);
     nonlinearStepSingle(nonlinearForce, discretization_weights, u_n);
   }
@@ -15,9 +15,18 @@
 #include <cmath>
 #include <boost/scoped_ptr.hpp>
 #include <algorithm>
+#include <vector>
 
 #include <dune/navier/thetascheme_traits.hh>
 #include <dune/navier/fractionaldatawriter.hh>
+#include <dune/navier/nestediteration.hh>
+#include <dune/navier/checkpoint.hh>
+#include <dune/navier/outputscheduler.hh>
+#include <dune/navier/probes.hh>
+#include <dune/navier/boundarymonitor.hh>
+#include <dune/navier/derivedfields.hh>
+#include <dune/navier/errorkernel.hh>
+#include <dune/navier/runconfig.hh>
 #include <dune/navier/global_defines.hh>
 #include <dune/oseen/pass.hh>
 
@@ -35,7 +44,6 @@ protected:
   typedef typename TupleSerializerType1::TupleType OutputTupleType1;
   typedef TimeAwareDataWriter<typename Traits::TimeProviderType, typename Traits::GridPartType::GridType,
                               OutputTupleType1> DataWriterType1;
-  typedef CheckPointer<typename Traits::GridPartType::GridType, OutputTupleType1> CheckPointerType;
   typedef Stuff::TupleSerializer<typename Traits::DiscreteOseenFunctionWrapperType> TupleSerializerType2;
   typedef typename TupleSerializerType2::TupleType OutputTupleType2;
   typedef TimeAwareDataWriter<typename Traits::TimeProviderType, typename Traits::GridPartType::GridType,
@@ -43,9 +51,17 @@ protected:
   typedef Dune::Oseen::RhsDatacontainer<typename Traits::OseenModelTraits> DataContainerType;
   typedef typename Traits::DiscreteOseenFunctionWrapperType::DiscreteVelocityFunctionType DiscreteVelocityFunctionType;
   typedef typename Traits::DiscreteOseenFunctionWrapperType::DiscretePressureFunctionType DiscretePressureFunctionType;
+  typedef DerivedFields<DiscreteVelocityFunctionType, DiscretePressureFunctionType> DerivedFieldsType;
+  typedef TimeAwareDataWriter<typename Traits::TimeProviderType, typename Traits::GridPartType::GridType,
+                              typename DerivedFieldsType::TupleType> DataWriterType3;
+  typedef NestedIterationState<typename Traits::GridPartType::GridType> NestedIterationStateType;
+  typedef Probes<typename Traits::GridPartType> ProbesType;
+  typedef ErrorKernel<typename Traits::GridPartType> ErrorKernelType;
+  typedef BoundaryMonitor<typename Traits::GridPartType> BoundaryMonitorType;
 
   mutable typename Traits::GridPartType gridPart_;
-  const typename Traits::ThetaSchemeDescriptionType& scheme_params_;
+  //! held by value since adaptive time stepping rescales the sub-step sizes during the run
+  typename Traits::ThetaSchemeDescriptionType scheme_params_;
 
 protected:
   CommunicatorType communicator_;
@@ -60,14 +76,43 @@ protected:
   mutable typename Traits::DiscreteOseenFunctionWrapperType rhsFunctions_;
   OutputTupleType1& data_tuple_1;
   DataWriterType1 dataWriter1_;
-  CheckPointerType check_pointer_;
   DataWriterType2 dataWriter2_;
+  //! buffers for magnitude, vorticity, divergence of the current velocity, only refreshed when output is written
+  DerivedFieldsType derivedFields_;
+  DataWriterType3 dataWriter3_;
   const typename Traits::OseenPassType::Traits::DiscreteSigmaFunctionSpaceType sigma_space_;
   mutable DataContainerType rhsDatacontainer_;
   mutable typename Traits::DiscreteOseenFunctionWrapperType lastFunctions_;
 
   typedef Stuff::L2Error<typename Traits::GridPartType> L2ErrorType;
   L2ErrorType l2Error_;
+  ErrorKernelType error_kernel_;
+  //! whether exactSolution_ holds the projection for exact_time_, see projectedExactSolution
+  bool exact_projected_;
+  double exact_time_;
+  //! dofs to start from instead of the exact initial data, see setInitialData
+  std::vector<double> initial_data_;
+  //! solution of a coarser run to prolong instead of the exact initial data, may be NULL
+  const NestedIterationStateType* nested_initial_data_;
+  bool output_enabled_;
+  //! whether the last writeData call actually wrote the current state
+  bool current_state_written_;
+  //! relative rate of change below which the flow counts as steady, 0 disables the monitor
+  const double steady_state_tolerance_;
+  //! number of consecutive steady steps before the run is stopped
+  const int steady_state_patience_;
+  //! solution at the start of the current time step, only allocated with the monitor enabled
+  boost::scoped_ptr<typename Traits::DiscreteOseenFunctionWrapperType> steady_state_reference_;
+  CheckpointRotation checkpoints_;
+  OutputScheduler output_scheduler_;
+  //! snapshot to resume from, empty for a fresh start
+  const std::string restart_file_;
+  const bool probes_enabled_;
+  //! created on the first sample, so runs without output don't touch the probe file
+  boost::scoped_ptr<ProbesType> probes_;
+  const bool boundary_monitor_enabled_;
+  //! like probes_ created on first use
+  boost::scoped_ptr<BoundaryMonitorType> boundary_monitor_;
 
 public:
   const double viscosity_;
@@ -95,59 +140,73 @@ public:
     , rhsFunctions_("rhs-adapter", functionSpaceWrapper_, gridPart_)
     , data_tuple_1(TupleSerializerType1::getTuple(currentFunctions_, errorFunctions_, exactSolution_, dummyFunctions_))
     , dataWriter1_(timeprovider_, gridPart_.grid(), data_tuple_1)
-    , check_pointer_(gridPart_.grid(), data_tuple_1, timeprovider_)
-    , dataWriter2_(timeprovider_, gridPart_.grid(), TupleSerializerType2::getTuple(updateFunctions_, rhsFunctions_))
+    , dataWriter2_(timeprovider_, gridPart_.grid(), TupleSerializerType2::getTuple(updateFunctions_, rhsFunctions_),
+                   "updates")
+    , derivedFields_(currentFunctions_.discretePressure().space())
+    , dataWriter3_(timeprovider_, gridPart_.grid(), derivedFields_.tuple(), "derived")
     , sigma_space_(gridPart_)
     , rhsDatacontainer_(currentFunctions_.discreteVelocity().space(), sigma_space_)
     , lastFunctions_("last", functionSpaceWrapper_, gridPart_)
     , l2Error_(gridPart)
+    , error_kernel_(gridPart_)
+    , exact_projected_(true)
+    , exact_time_(timeprovider_.subTime())
+    , nested_initial_data_(NULL)
+    , output_enabled_(true)
+    , current_state_written_(false)
+    , steady_state_tolerance_(Parameters().getParam("steady_state_tolerance", 0.0, Dune::ValidateNotLess<double>(0.0)))
+    , steady_state_patience_(Parameters().getParam("steady_state_patience", 3, Dune::ValidateNotLess<int>(1)))
+    , checkpoints_(communicator_.rank(), communicator_.size())
+    , output_scheduler_(timeprovider_.startTime())
+    , restart_file_(checkpoints_.restartFile())
+    , probes_enabled_(ProbesType::enabled())
+    , boundary_monitor_enabled_(BoundaryMonitorType::enabled())
     , viscosity_(Parameters().getParam("viscosity", 1.0, Dune::ValidateNotLess<double>(0.0)))
     , d_t_(timeprovider_.deltaT())
     , reynolds_(1.0 / viscosity_)
     , current_max_gridwidth_(Dune::GridWidth::calcGridWidth(gridPart_)) {
     Logger().Info() << scheme_params_;
+    if (NAVIER_DATA_NAMESPACE::hasExactSolution && runConfig().calculate_errors)
+      Logger().Info() << "errors are measured against the analytical solution, not its projection, H1 parts use "
+                         "central differences (2*dim extra evaluations per quadrature point)\n";
     NAVIER_DATA_NAMESPACE::SetupCheck check;
     if (!check(this, gridPart_, scheme_params_, timeprovider_, functionSpaceWrapper_))
       DUNE_THROW(InvalidStateException, check.error());
+    if (steady_state_tolerance_ > 0.0)
+      steady_state_reference_.reset(
+          new typename Traits::DiscreteOseenFunctionWrapperType("steady_reference", functionSpaceWrapper_, gridPart_));
   }
 
   void nextStep(const int step, Stuff::RunInfo& info) {
     current_max_gridwidth_ = Dune::GridWidth::calcGridWidth(gridPart_);
     lastFunctions_.assign(currentFunctions_);
     currentFunctions_.assign(nextFunctions_);
-    exactSolution_.project();
+    // errors are measured against the analytical solution, the projection is made on demand by its readers
+    exact_projected_ = false;
+    exact_time_ = timeprovider_.subTime();
     const bool last_substep = (step == (Traits::ThetaSchemeDescriptionType::numberOfSteps_ - 1));
+    // intermediate sub-steps of a step that may still be rejected neither produce output nor abort the run,
+    // the last sub-step is only taken after the step was accepted
+    const bool tentative = !last_substep && substepsMayBeRejected();
 
     // error calc
-    if (NAVIER_DATA_NAMESPACE::hasExactSolution && Parameters().getParam("calculate_errors", true)) {
+    if (!tentative && NAVIER_DATA_NAMESPACE::hasExactSolution && runConfig().calculate_errors) {
       Stuff::Profiler::ScopedTiming error_time("error_calc");
 
-      errorFunctions_.discretePressure().assign(exactSolution_.discretePressure());
-      errorFunctions_.discretePressure() -= currentFunctions_.discretePressure();
-      errorFunctions_.discreteVelocity().assign(exactSolution_.discreteVelocity());
-      errorFunctions_.discreteVelocity() -= currentFunctions_.discreteVelocity();
-
-      double meanPressure_exact =
-          Stuff::integralAndVolume(exactSolution_.exactPressure(), currentFunctions_.discretePressure().space()).first;
-      double meanPressure_discrete = Stuff::integralAndVolume(currentFunctions_.discretePressure(),
-                                                              currentFunctions_.discretePressure().space()).first;
-
-      Dune::L2Norm<typename Traits::GridPartType> l2_Error(gridPart_);
-      Dune::H1Norm<typename Traits::GridPartType> h1_Error(gridPart_);
-
-      //						if ( Parameters().getParam( "error_scaling", false ) ) {
-      //								const double scale		= 1 / std::sqrt( viscosity_ );
-      //								errorFunctions_.discretePressure() *= scale;
-      //								errorFunctions_.discreteVelocity() *= scale;
-      //						}
-
-      const double l2_error_pressure_ = l2_Error.norm(errorFunctions_.discretePressure());
-      const double l2_error_velocity_ = l2_Error.norm(errorFunctions_.discreteVelocity());
-      const double h1_error_pressure_ = h1_Error.norm(errorFunctions_.discretePressure());
-      const double h1_error_velocity_ = h1_Error.norm(errorFunctions_.discreteVelocity());
-      const double relative_l2_error_pressure_ = l2_error_pressure_ / l2_Error.norm(exactSolution_.discretePressure());
-      const double relative_l2_error_velocity_ = l2_error_velocity_ / l2_Error.norm(exactSolution_.discreteVelocity());
-      const double relative_h1_error_velocity_ = h1_error_velocity_ / h1_Error.norm(exactSolution_.discreteVelocity());
+      // errorFunctions_ are only assembled for output, see writeData
+      const typename ErrorKernelType::Result errors =
+          error_kernel_.compute(exactSolution_.exactVelocity(), exactSolution_.exactPressure(),
+                                currentFunctions_.discreteVelocity(), currentFunctions_.discretePressure());
+      const double meanPressure_exact = errors.mean_pressure_exact;
+      const double meanPressure_discrete = errors.mean_pressure_discrete;
+
+      const double l2_error_pressure_ = errors.l2_error_pressure;
+      const double l2_error_velocity_ = errors.l2_error_velocity;
+      const double h1_error_pressure_ = errors.h1_error_pressure;
+      const double h1_error_velocity_ = errors.h1_error_velocity;
+      const double relative_l2_error_pressure_ = l2_error_pressure_ / errors.l2_pressure;
+      const double relative_l2_error_velocity_ = l2_error_velocity_ / errors.l2_velocity;
+      const double relative_h1_error_velocity_ = h1_error_velocity_ / errors.h1_velocity;
       std::vector<double> error_vector;
       error_vector.push_back(l2_error_velocity_);
       error_vector.push_back(l2_error_pressure_);
@@ -160,7 +219,8 @@ public:
 #endif
       {
         Logger().Info().Resume();
-        if (Parameters().getParam("parabolic", false))
+        // against the analytical solution, not its projection, so the projection error is included
+        if (runConfig().parabolic)
           Logger().Info() << boost::format("L2-Error Velocity (abs|rel): %e | %e") % l2_error_velocity_ %
                                  relative_l2_error_velocity_;
         else
@@ -175,13 +235,13 @@ public:
 #endif
         Logger().Info() << std::endl;
       }
-      const double max_l2_error = Parameters().getParam("max_error", 1e2, Dune::ValidateGreater<double>(0.0));
+      const double max_l2_error = runConfig().max_error;
       info.L2Errors = error_vector;
       info.H1Errors = h1_error_vector;
       if (l2_error_velocity_ > max_l2_error ||
-          (!Parameters().getParam("parabolic", false) && l2_error_pressure_ > max_l2_error))
+          (!runConfig().parabolic && l2_error_pressure_ > max_l2_error))
         throw Stuff::singlerun_abort_exception("Aborted, L2 error above " + Stuff::toString(max_l2_error));
-      if (!Parameters().getParam("parabolic", false) &&
+      if (!runConfig().parabolic &&
           (std::isnan(l2_error_velocity_) || std::isnan(l2_error_pressure_)))
         throw Stuff::singlerun_abort_exception("L2 error is Nan");
     }
@@ -204,28 +264,37 @@ public:
       info.c12 = Pair(stabil_coeff.Power("C12"), stabil_coeff.Factor("C12"));
       info.d11 = Pair(stabil_coeff.Power("D11"), stabil_coeff.Factor("D11"));
       info.d12 = Pair(stabil_coeff.Power("D12"), stabil_coeff.Factor("D12"));
-      info.bfg = Parameters().getParam("do-bfg", true);
+      info.bfg = runConfig().do_bfg;
       // TODO gridname
       //						info.gridname		= gridPart_.grid().name();
-      info.refine_level = Parameters().getParam("minref", 0, Dune::ValidateNotLess<int>(0));
+      info.refine_level = runConfig().minref;
 
       info.polorder_pressure = Traits::OseenModelTraits::pressureSpaceOrder;
       info.polorder_sigma = Traits::OseenModelTraits::sigmaSpaceOrder;
       info.polorder_velocity = Traits::OseenModelTraits::velocitySpaceOrder;
 
-      info.solver_accuracy = Parameters().getParam("absLimit", 1e-4);
-      info.inner_solver_accuracy = Parameters().getParam("inner_absLimit", 1e-4);
-      info.bfg_tau = Parameters().getParam("bfg-tau", 0.1);
+      info.solver_accuracy = runConfig().abs_limit;
+      info.inner_solver_accuracy = runConfig().inner_abs_limit;
+      info.bfg_tau = runConfig().bfg_tau;
 
       info.problemIdentifier = NAVIER_DATA_NAMESPACE::identifier;
       info.algo_id = scheme_params_.algo_id;
-      info.extra_info = (boost::format("%s on %s") % COMMIT % std::getenv("HOSTNAME")).str();
+      // the tables used to hold errors against the projected exact solution, say which ones these are
+      info.extra_info = (boost::format("%s on %s, errors vs. analytical solution (FD gradients)") % COMMIT %
+                         std::getenv("HOSTNAME")).str();
 
       Logger().Info() << boost::format("current time (substep %d ): %f (%f)\n") % step % timeprovider_.subTime() %
                              timeprovider_.previousSubTime();
+
+      if (boundary_monitor_enabled_ && output_enabled_) {
+        if (!boundary_monitor_)
+          boundary_monitor_.reset(new BoundaryMonitorType(gridPart_, viscosity_, !restart_file_.empty()));
+        boundary_monitor_->sample(timeprovider_.subTime(), currentFunctions_.discreteVelocity(),
+                                  currentFunctions_.discretePressure());
+      }
     }
 
-    if (last_substep || !Parameters().getParam("write_fulltimestep_only", false))
+    if (last_substep || (!tentative && !runConfig().write_fulltimestep_only))
       writeData();
     timeprovider_.nextFractional();
   }
@@ -234,18 +303,48 @@ public:
     typename Traits::TimeProviderType::StepZeroGuard step0(timeprovider_.stepZeroGuard(d_t_));
     // initial flow field at t = 0
     exactSolution_.project();
-    currentFunctions_.assign(exactSolution_);
-    nextFunctions_.assign(exactSolution_);
-    writeData();
+    exact_projected_ = true;
+    exact_time_ = timeprovider_.subTime();
+    DiscreteVelocityFunctionType& velocity = currentFunctions_.discreteVelocity();
+    DiscretePressureFunctionType& pressure = currentFunctions_.discretePressure();
+    bool exact_initial_data = initial_data_.empty();
+    if (nested_initial_data_ && !nested_initial_data_->empty()) {
+      Stuff::Profiler::ScopedTiming prolong_time("nested_iteration_prolongation");
+      exact_initial_data = !(nested_initial_data_->prolong(velocity, 0) && nested_initial_data_->prolong(pressure, 1));
+      if (exact_initial_data)
+        Logger().Err() << "coarse solution does not cover the grid, starting from exact initial data" << std::endl;
+    } else if (!exact_initial_data) {
+      if (initial_data_.size() != size_t(velocity.size() + pressure.size()))
+        DUNE_THROW(InvalidStateException, "initial data does not match the discrete function spaces");
+      const std::vector<double>::const_iterator pressure_begin = initial_data_.begin() + velocity.size();
+      std::copy(initial_data_.begin(), pressure_begin, velocity.dbegin());
+      std::copy(pressure_begin, initial_data_.end(), pressure.dbegin());
+    }
+    if (exact_initial_data) {
+      currentFunctions_.assign(exactSolution_);
+      nextFunctions_.assign(exactSolution_);
+    } else {
+      nextFunctions_.assign(currentFunctions_);
+      lastFunctions_.assign(currentFunctions_);
+    }
+    // a restarted run has written this already
+    if (restart_file_.empty()) {
+      writeData();
+      sampleProbes(0, timeprovider_.subTime());
+    }
     // the guard dtor sets current time to t_0 + dt_k
   }
 
   Stuff::RunInfoTimeMap run() {
     Stuff::RunInfoTimeMap runInfoMap;
     Init();
+    int full_steps = restart_file_.empty() ? 0 : restoreCheckpoint();
+    int steady_steps = 0;
 
     for (; timeprovider_.time() <= timeprovider_.endTime();) {
       assert(timeprovider_.time() > 0.0);
+      if (steady_state_reference_)
+        steady_state_reference_->assign(currentFunctions_);
       Stuff::RunInfo info = full_timestep();
       const double real_time = timeprovider_.subTime();
       try {
@@ -259,31 +358,214 @@ public:
           timeprovider_.nextFractional();
           runInfoMap[timeprovider_.subTime()] = Stuff::RunInfo::dummy();
         }
+        flushOutput();
         return runInfoMap;
       }
       timeprovider_.printRemainderEstimate(Logger().Info());
       runInfoMap[real_time] = info;
+      // intermediate propagations (parareal) have output disabled, their snapshots could never be used
+      if (checkpoints_.due(++full_steps) && output_enabled_)
+        writeCheckpoint(full_steps);
+      sampleProbes(full_steps, real_time);
+      steady_steps = steady_state_reference_ && isSteady(real_time) ? steady_steps + 1 : 0;
+      if (steady_steps >= steady_state_patience_) {
+        // the scheduler may have skipped this step, the final state has to end up in the output either way
+        Logger().Info() << boost::format("steady state reached at t = %f, stopping\n") % real_time;
+        if (!current_state_written_)
+          writeData(true);
+        // the map ends here, later time levels were never computed
+        break;
+      }
     }
     assert(runInfoMap.size() > 0);
+    flushOutput();
     return runInfoMap;
   }
 
+  //! errors of the asynchronous writers surface here at the latest
+  void flushOutput() const {
+    dataWriter1_.flush();
+    dataWriter2_.flush();
+    dataWriter3_.flush();
+  }
+
   virtual Stuff::RunInfo full_timestep() = 0;
 
+  //! true for schemes that may discard the sub-steps of a full step again, i.e. with adaptive step size control
+  virtual bool substepsMayBeRejected() const { return false; }
+
+  /** \brief exactSolution_ with its discrete functions projected at the time of the last nextStep
+    * The projection is made at most once per time level and only if somebody reads it: output, cheatRHS, the first
+    * step and the rhs_cheat paths of the schemes. The errors in nextStep do not need it.
+    */
+  const ExactSolutionType& projectedExactSolution() {
+    if (!exact_projected_) {
+      Stuff::Profiler::ScopedTiming projection_time("exact_projection");
+      exactSolution_.atTime(exact_time_, exactSolution_);
+      exact_projected_ = true;
+    }
+    return exactSolution_;
+  }
+
+  /** \brief rate of change of the last time step, relative to the solution, compared to steady_state_tolerance_
+    * \f$\|u^{n+1} - u^n\| / (\Delta t \|u^{n+1}\|)\f$ is checked for velocity and pressure. This is an increment test,
+    * not the residual of the steady equations, which is never assembled. Consumes steady_state_reference_.
+    */
+  bool isSteady(const double time) {
+    Stuff::Profiler::ScopedTiming steady_time("steady_state_check");
+    typename Traits::DiscreteOseenFunctionWrapperType& difference = *steady_state_reference_;
+    difference -= currentFunctions_;
+    const double dt = timeprovider_.deltaT();
+    const double velocity_rate =
+        std::sqrt(difference.discreteVelocity().scalarProductDofs(difference.discreteVelocity()) /
+                  std::max(currentFunctions_.discreteVelocity().scalarProductDofs(currentFunctions_.discreteVelocity()),
+                           1e-20)) /
+        dt;
+    const double pressure_rate =
+        std::sqrt(difference.discretePressure().scalarProductDofs(difference.discretePressure()) /
+                  std::max(currentFunctions_.discretePressure().scalarProductDofs(currentFunctions_.discretePressure()),
+                           1e-20)) /
+        dt;
+    Logger().Dbg() << boost::format("t = %f: relative rate of change velocity %e, pressure %e\n") % time %
+                          velocity_rate % pressure_rate;
+    return std::max(velocity_rate, pressure_rate) < steady_state_tolerance_;
+  }
+
+  void sampleProbes(const int full_steps, const double time) {
+    if (!probes_enabled_ || !output_enabled_)
+      return;
+    if (!probes_)
+      probes_.reset(new ProbesType(gridPart_, !restart_file_.empty()));
+    probes_->sample(full_steps, time, currentFunctions_.discreteVelocity(), currentFunctions_.discretePressure());
+  }
+
   void setUpdateFunctions() const {
     updateFunctions_.assign(nextFunctions_);
     updateFunctions_ -= currentFunctions_;
   }
 
-  void writeData() {
+  /** \brief snapshot of everything the time loop depends on
+    * The grid itself is not stored, it is rebuilt from the DGF file and refine level, only its size is recorded to
+    * detect a mismatch. Derived schemes add their own buffers in checkpointData.
+    */
+  void writeCheckpoint(const int full_steps) {
+    Stuff::Profiler::ScopedTiming checkpoint_time("checkpoint");
+    const std::string filename = checkpoints_.filename(full_steps);
+    CheckpointOutput out(filename, checkpoints_.compressionLevel());
+    out.scalar(int(gridPart_.grid().size(0)));
+    out.scalar(communicator_.size());
+    out.scalar(communicator_.rank());
+    out.scalar(full_steps);
+    out.scalar(dataWriter1_.writeStep());
+    out.scalar(dataWriter2_.writeStep());
+    output_scheduler_.checkpoint(out);
+    timeprovider_.writeState(out);
+    checkpointFunctions(out);
+    checkpointData(out);
+    out.close();
+    checkpoints_.committed(filename);
+  }
+
+  //! \return the number of full time steps done before the snapshot was taken
+  int restoreCheckpoint() {
+    Stuff::Profiler::ScopedTiming checkpoint_time("checkpoint");
+    CheckpointInput in(restart_file_);
+    in.check(int(gridPart_.grid().size(0)), "grid");
+    // equal element counts do not tell the partitions apart
+    in.check(communicator_.size(), "number of ranks");
+    in.check(communicator_.rank(), "rank");
+    int full_steps, write_step;
+    in.scalar(full_steps);
+    in.scalar(write_step);
+    dataWriter1_.setWriteStep(write_step);
+    // always written together with the first one
+    dataWriter3_.setWriteStep(write_step);
+    in.scalar(write_step);
+    dataWriter2_.setWriteStep(write_step);
+    output_scheduler_.checkpoint(in);
+    timeprovider_.readState(in);
+    checkpointFunctions(in);
+    checkpointData(in);
+    Logger().Info() << boost::format("resumed from %s at t = %f\n") % restart_file_ % timeprovider_.subTime();
+    return full_steps;
+  }
+
+  template <class Archive>
+  void checkpointFunctions(Archive& archive) {
+    typename Traits::DiscreteOseenFunctionWrapperType* const functions[] = {&currentFunctions_, &nextFunctions_,
+                                                                             &lastFunctions_};
+    for (size_t i = 0; i < 3; ++i) {
+      archive.function(functions[i]->discreteVelocity());
+      archive.function(functions[i]->discretePressure());
+    }
+    // the explicit parts of the next sub-step's rhs
+    archive.function(rhsDatacontainer_.velocity_laplace);
+    archive.function(rhsDatacontainer_.pressure_gradient);
+    archive.function(rhsDatacontainer_.convection);
+    archive.function(rhsDatacontainer_.velocity_gradient);
+  }
+
+  //! hooks for scheme specific state, both have to process the same data in the same order
+  virtual void checkpointData(CheckpointOutput& /*out*/) {}
+  virtual void checkpointData(CheckpointInput& /*in*/) {}
+
+  //! \a force bypasses output_policy, except for "none"
+  void writeData(const bool force = false) {
+    current_state_written_ = false;
+    if (!output_enabled_ || output_scheduler_.disabled())
+      return;
+    double relative_change = 0.0;
+    if (output_scheduler_.needsChange()) {
+      const double update = updateFunctions_.discreteVelocity().scalarProductDofs(updateFunctions_.discreteVelocity());
+      const double norm = currentFunctions_.discreteVelocity().scalarProductDofs(currentFunctions_.discreteVelocity());
+      relative_change = std::sqrt(update / std::max(norm, 1e-20));
+    }
+    if (!force && !output_scheduler_.due(timeprovider_.subTime(), timeprovider_.timeStep(), relative_change))
+      return;
+    current_state_written_ = true;
     Stuff::Profiler::ScopedTiming io_time("IO");
+    if (NAVIER_DATA_NAMESPACE::hasExactSolution)
+      projectedExactSolution();
+    if (NAVIER_DATA_NAMESPACE::hasExactSolution && runConfig().calculate_errors) {
+      errorFunctions_.discretePressure().assign(exactSolution_.discretePressure());
+      errorFunctions_.discretePressure() -= currentFunctions_.discretePressure();
+      errorFunctions_.discreteVelocity().assign(exactSolution_.discreteVelocity());
+      errorFunctions_.discreteVelocity() -= currentFunctions_.discreteVelocity();
+    }
     dataWriter1_.write();
     dataWriter2_.write();
-    //					check_pointer_.write( timeprovider_.time(), timeprovider_.timeStep() );
+    if (!derivedFields_.empty()) {
+      derivedFields_.update(currentFunctions_.discreteVelocity());
+      dataWriter3_.write();
+    }
   }
 
   DataContainerType& rhsDatacontainer() { return rhsDatacontainer_; }
 
+  //! start run() from \a state (velocity dofs followed by pressure dofs) instead of the exact initial data
+  void setInitialData(const std::vector<double>& state) { initial_data_ = state; }
+
+  //! velocity dofs followed by pressure dofs of the current solution
+  void getState(std::vector<double>& state) const {
+    const DiscreteVelocityFunctionType& velocity = currentFunctions_.discreteVelocity();
+    const DiscretePressureFunctionType& pressure = currentFunctions_.discretePressure();
+    state.resize(velocity.size() + pressure.size());
+    std::copy(pressure.dbegin(), pressure.dend(), std::copy(velocity.dbegin(), velocity.dend(), state.begin()));
+  }
+
+  /** start run() from the prolongation of the solution in \a state, which was stored on a coarser level of the same
+    * grid hierarchy (nested iteration). \a state has to outlive run().
+    */
+  void setInitialData(const NestedIterationStateType& state) { nested_initial_data_ = &state; }
+
+  void getState(NestedIterationStateType& state) const {
+    state.store(currentFunctions_.discreteVelocity(), 0);
+    state.store(currentFunctions_.discretePressure(), 1);
+  }
+
+  //! disables all data/vtk output, used for intermediate propagations that nobody wants to look at
+  void setOutputEnabled(const bool enabled) { output_enabled_ = enabled; }
+
   const ExactSolutionType& exactSolution() const { return exactSolution_; }
 
   const typename Traits::DiscreteOseenFunctionWrapperType& currentFunctions() const { return currentFunctions_; }
@@ -300,7 +582,7 @@ public:
     VelocityLaplace velocity_laplace(timeprovider_, continousVelocitySpace_);
     Dune::BetterL2Projection::project(timeprovider_.previousSubTime(), velocity_laplace,
                                       rhsDatacontainer_.velocity_laplace);
-    currentFunctions_.discreteVelocity().assign(exactSolution_.discreteVelocity());
+    currentFunctions_.discreteVelocity().assign(projectedExactSolution().discreteVelocity());
 
     typedef NAVIER_DATA_NAMESPACE::VelocityConvection<VelocityFunctionSpaceType, typename Traits::TimeProviderType>
     VelocityConvection;
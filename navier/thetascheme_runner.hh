@@ -6,6 +6,8 @@
 #include <dune/navier/thetascheme_alt_split.hh>
 #include <dune/navier/global_defines.hh>
 #include <dune/common/static_assert.hh>
+#include <algorithm>
+#include <vector>
 
 template <class GridType, class CollectiveCommunicationType>
 class ThetaschemeRunner {
@@ -18,6 +20,12 @@ private:
   typedef typename OneStepThetaSchemeTraitsType::ThetaSchemeDescriptionType OneStepThetaSchemeDescriptionType;
   typedef Dune::NavierStokes::DataOnlyScheme<OneStepThetaSchemeTraitsType> DataOnlySchemeType;
   typedef typename OneStepThetaSchemeTraitsType::ThetaSchemeDescriptionType DataOnlySchemeDescriptionType;
+  typedef Dune::NavierStokes::ThetaSchemeTraits<
+      CollectiveCommunicationType, GridType, NAVIER_DATA_NAMESPACE::Force, NAVIER_DATA_NAMESPACE::DirichletData,
+      NAVIER_DATA_NAMESPACE::Pressure, NAVIER_DATA_NAMESPACE::Velocity, 2, // number of substeps
+      GridType::dimensionworld, POLORDER, VELOCITY_POLORDER, PRESSURE_POLORDER> TwoStepThetaSchemeTraitsType;
+  typedef Dune::NavierStokes::ThetaScheme<TwoStepThetaSchemeTraitsType> TwoStepThetaSchemeType;
+  typedef typename TwoStepThetaSchemeTraitsType::ThetaSchemeDescriptionType TwoStepThetaSchemeDescriptionType;
   typedef Dune::NavierStokes::ThetaSchemeTraits<
       CollectiveCommunicationType, GridType, NAVIER_DATA_NAMESPACE::Force, NAVIER_DATA_NAMESPACE::DirichletData,
       NAVIER_DATA_NAMESPACE::Pressure, NAVIER_DATA_NAMESPACE::Velocity, 3, // number of substeps
@@ -39,32 +47,79 @@ public:
   }
 
   Stuff::RunInfoTimeMap run(const int scheme_type) {
+    std::vector<double> state;
+    return run(scheme_type, state, true);
+  }
+
+  /** \brief run scheme_type on [fem.timeprovider.starttime, fem.timeprovider.endtime]
+    * starts from \a state if it is non-empty, from the exact initial data otherwise, and returns the final solution
+    * in \a state (either velocity dofs followed by pressure dofs or a NestedIterationState)
+    **/
+  template <class StateType>
+  Stuff::RunInfoTimeMap run(const int scheme_type, StateType& state, const bool write_output) {
     const double dt_ = Parameters().getParam("fem.timeprovider.dt", double(0.1), Dune::ValidateGreater<double>(0.0));
     switch (scheme_type) {
       case 1:
-        return OneStepThetaSchemeType(grid_part_, OneStepThetaSchemeDescriptionType::forward_euler(dt_)).run();
+        return execute<OneStepThetaSchemeType>(OneStepThetaSchemeDescriptionType::forward_euler(dt_), state,
+                                               write_output);
       case 2:
-        return OneStepThetaSchemeType(grid_part_, OneStepThetaSchemeDescriptionType::backward_euler(dt_)).run();
+        return execute<OneStepThetaSchemeType>(OneStepThetaSchemeDescriptionType::backward_euler(dt_), state,
+                                               write_output);
       case 3:
-        return OneStepThetaSchemeType(grid_part_, OneStepThetaSchemeDescriptionType::crank_nicholson(dt_)).run();
+        return execute<OneStepThetaSchemeType>(OneStepThetaSchemeDescriptionType::crank_nicholson(dt_), state,
+                                               write_output);
       case 4:
         if (Parameters().getParam("old_timestep", false))
-          return ThreeStepThetaSchemeAltSplittingType(grid_part_, ThreeStepThetaSchemeDescriptionType::fs0(dt_)).run();
+          return execute<ThreeStepThetaSchemeAltSplittingType>(ThreeStepThetaSchemeDescriptionType::fs0(dt_), state,
+                                                               write_output);
         else
-          return ThreeStepThetaSchemeType(grid_part_, ThreeStepThetaSchemeDescriptionType::fs0(dt_)).run();
+          return execute<ThreeStepThetaSchemeType>(ThreeStepThetaSchemeDescriptionType::fs0(dt_), state, write_output);
       default:
         Logger().Info() << "Using default value for theta scheme type\n";
       case 5:
         if (Parameters().getParam("old_timestep", false))
-          return ThreeStepThetaSchemeAltSplittingType(grid_part_, ThreeStepThetaSchemeDescriptionType::fs1(dt_)).run();
+          return execute<ThreeStepThetaSchemeAltSplittingType>(ThreeStepThetaSchemeDescriptionType::fs1(dt_), state,
+                                                               write_output);
         else
-          return ThreeStepThetaSchemeType(grid_part_, ThreeStepThetaSchemeDescriptionType::fs1(dt_)).run();
+          return execute<ThreeStepThetaSchemeType>(ThreeStepThetaSchemeDescriptionType::fs1(dt_), state, write_output);
+      case 6:
+        return execute<OneStepThetaSchemeType>(OneStepThetaSchemeDescriptionType::bdf2(dt_), state, write_output);
+      case 7:
+        return execute<OneStepThetaSchemeType>(OneStepThetaSchemeDescriptionType::imex_bdf2(dt_), state, write_output);
+      case 8: {
+        // stage count picks the traits, the tableau itself is only known at runtime
+        const std::string tableau = Parameters().getParam("dirk_tableau", std::string("1"));
+        switch (std::count(tableau.begin(), tableau.end(), ';') + 1) {
+          case 1:
+            return execute<OneStepThetaSchemeType>(OneStepThetaSchemeDescriptionType::dirk(dt_, tableau), state,
+                                                   write_output);
+          case 2:
+            return execute<TwoStepThetaSchemeType>(TwoStepThetaSchemeDescriptionType::dirk(dt_, tableau), state,
+                                                   write_output);
+          case 3:
+            return execute<ThreeStepThetaSchemeType>(ThreeStepThetaSchemeDescriptionType::dirk(dt_, tableau), state,
+                                                     write_output);
+          default:
+            DUNE_THROW(Dune::NotImplemented, "DIRK schemes with more than three stages");
+        }
+      }
       case 0:
-        return DataOnlySchemeType(grid_part_, DataOnlySchemeDescriptionType::crank_nicholson(dt_)).run();
+        return execute<DataOnlySchemeType>(DataOnlySchemeDescriptionType::crank_nicholson(dt_), state, write_output);
     }
   }
 
 private:
+  template <class SchemeType, class DescriptionType, class StateType>
+  Stuff::RunInfoTimeMap execute(const DescriptionType& description, StateType& state, const bool write_output) {
+    SchemeType scheme(grid_part_, description, comm_);
+    if (!state.empty())
+      scheme.setInitialData(state);
+    scheme.setOutputEnabled(write_output);
+    const Stuff::RunInfoTimeMap ret = scheme.run();
+    scheme.getState(state);
+    return ret;
+  }
+
   typename ThreeStepThetaSchemeTraitsType::GridPartType grid_part_;
   CollectiveCommunicationType& comm_;
 };
@@ -8,11 +8,13 @@
 #include <dune/navier/exactsolution.hh>
 #include <dune/stuff/functions.hh>
 #include <dune/stuff/misc.hh>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 
 namespace Dune {
 namespace NavierStokes {
 namespace {
-const std::string scheme_names_array[] = {"N.A.", "FWE", "BWE", "CN", "FS0", "FS1"};
+const std::string scheme_names_array[] = {"N.A.", "FWE", "BWE", "CN", "FS0", "FS1", "BDF2", "IMEX", "DIRK"};
 }
 //! for each step keep a set of theta values and one value for dt
 // thetas_[stepnumber][theta_subscript_index]
@@ -102,10 +104,101 @@ public:
     c[2] = theta * delta_t;
     return ReturnType(a, c, scheme_names[5]);
   }
+
+  /** \brief constant step BDF2 written as a one-step theta scheme
+    * \f$u_{n+1} - u^{*} + \frac{2}{3}\delta t A(u_{n+1}) = \frac{2}{3}\delta t f_{n+1}\f$ with
+    * \f$u^{*} = \frac{4}{3}u_{n} - \frac{1}{3}u_{n-1}\f$. The scheme forms \f$u^{*}\f$ and adapts the weights to
+    * variable step sizes, the first step is done with backward euler
+    **/
+  static ThetaSchemeDescription<1> bdf2(double delta_t) {
+    ThetaValueArray c = {{2.0 / 3.0, 0.0f, 0.0f, 2.0 / 3.0}};
+    ThetaArray a;
+    Stuff::fill_entirely(a, c);
+    return ThetaSchemeDescription<1>(a, delta_t, scheme_names[6]);
+  }
+  //! BDF2 with the convection term extrapolated from \f$u_{n}, u_{n-1}\f$ and moved to the rhs
+  static ThetaSchemeDescription<1> imex_bdf2(double delta_t) {
+    ThetaSchemeDescription<1> ret = bdf2(delta_t);
+    ret.algo_id = scheme_names[7];
+    return ret;
+  }
+
+  /** \brief stiffly accurate DIRK scheme given by the lower triangle of its Butcher tableau
+    * rows are separated by ';', entries by whitespace, e.g. "0.29289321881; 0.70710678119 0.29289321881" for the
+    * L-stable two-stage SDIRK. Stage i becomes a sub-step with \f$\theta_1 = \theta_4 = a_{ii}\f$,
+    * \f$\theta_2 = \theta_3 = a_{i,i-1} - a_{i-1,i-1}\f$ and step size \f$(c_i - c_{i-1})\delta t\f$, hence each stage
+    * may only couple to the previous one: \f$a_{ij} = a_{i-1,j}\f$ for \f$j < i-1\f$.
+    **/
+  static ThisType dirk(double delta_t, const std::string& tableau) {
+    const double eps = 1e-12;
+    std::vector<std::string> rows;
+    boost::split(rows, tableau, boost::is_any_of(";"));
+    if (int(rows.size()) != numberOfSteps)
+      DUNE_THROW(InvalidStateException, "DIRK tableau has " << rows.size() << " rows, expected " << numberOfSteps);
+    std::vector<std::vector<double>> a(numberOfSteps);
+    for (int i = 0; i < numberOfSteps; ++i) {
+      std::vector<std::string> entries;
+      const std::string row = boost::trim_copy(rows[i]);
+      boost::split(entries, row, boost::is_any_of(" \t,"), boost::token_compress_on);
+      if (int(entries.size()) != i + 1)
+        DUNE_THROW(InvalidStateException, "row " << i + 1 << " of the DIRK tableau needs " << i + 1 << " entries");
+      try {
+        for (size_t j = 0; j < entries.size(); ++j)
+          a[i].push_back(boost::lexical_cast<double>(entries[j]));
+      }
+      catch (boost::bad_lexical_cast&) {
+        DUNE_THROW(InvalidStateException, "cannot parse row " << i + 1 << " of the DIRK tableau: " << rows[i]);
+      }
+    }
+    ThetaArray thetas;
+    TimestepArray step_sizes;
+    double c_previous = 0.0;
+    for (int i = 0; i < numberOfSteps; ++i) {
+      double c = 0.0;
+      for (int j = 0; j <= i; ++j)
+        c += a[i][j];
+      if (a[i][i] <= 0.0)
+        DUNE_THROW(InvalidStateException, "DIRK stage " << i + 1 << " is not implicit");
+      if (c <= c_previous)
+        DUNE_THROW(InvalidStateException, "DIRK abscissae need to be strictly increasing");
+      for (int j = 0; j + 1 < i; ++j) {
+        if (std::fabs(a[i][j] - a[i - 1][j]) > eps)
+          DUNE_THROW(InvalidStateException, "DIRK stage " << i + 1 << " couples to stages other than the previous one");
+      }
+      const double theta_implicit = a[i][i];
+      const double theta_explicit = i > 0 ? a[i][i - 1] - a[i - 1][i - 1] : 0.0;
+      ThetaValueArray stage = {{theta_implicit, theta_explicit, theta_explicit, theta_implicit}};
+      thetas[i] = stage;
+      step_sizes[i] = (c - c_previous) * delta_t;
+      c_previous = c;
+    }
+    if (std::fabs(c_previous - 1.0) > eps)
+      DUNE_THROW(InvalidStateException, "DIRK tableau is not stiffly accurate, the last row has to sum up to one");
+    return ThisType(thetas, step_sizes, scheme_names[8]);
+  }
+
+  //! true for the schemes that need u_{n-1} beyond the theta weights
+  bool isMultistep() const { return algo_id == scheme_names[6] || algo_id == scheme_names[7]; }
+
+  //! return t_{n+1} - t_{n}, i.e. the sum of all sub-step sizes
+  double deltaT() const {
+    double dt = 0.0;
+    for (int i = 0; i < numberOfSteps; ++i)
+      dt += step_sizes_[i];
+    return dt;
+  }
+
+  //! scale all sub-step sizes so that they add up to delta_t, theta values are relative and stay untouched
+  void rescale(const double delta_t) {
+    assert(delta_t > 0.0);
+    const double factor = delta_t / deltaT();
+    for (int i = 0; i < numberOfSteps; ++i)
+      step_sizes_[i] *= factor;
+  }
 };
 
 template <int N>
-const std::vector<std::string> ThetaSchemeDescription<N>::scheme_names(scheme_names_array, scheme_names_array + 6);
+const std::vector<std::string> ThetaSchemeDescription<N>::scheme_names(scheme_names_array, scheme_names_array + 9);
 
 template <class Stream, int N>
 inline Stream& operator<<(Stream& s, ThetaSchemeDescription<N> desc) {
@@ -0,0 +1,316 @@
+#ifndef VTUWRITER_HH
+#define VTUWRITER_HH
+
+#include <dune/grid/io/file/vtk/common.hh>
+#include <dune/grid/common/genericreferenceelements.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/stuff/parametercontainer.hh>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/cstdint.hpp>
+#include <zlib.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cmath>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief the VTK flavours the data writers support, chosen by vtk_format
+  * ascii, base64 and appendedraw are handed to Dune::VTKWriter, zlib uses CompressedVTUWriter.
+  * Without vtk_format the old binary_vtk switch selects between base64 and ascii.
+  */
+struct VTKFormat {
+  enum Type {
+    ascii,
+    base64,
+    appendedraw,
+    zlib
+  };
+
+  static Type fromParameters() {
+    if (!Dune::Parameter::exists("vtk_format"))
+      return Parameters().getParam("binary_vtk", true) ? base64 : ascii;
+    const std::string name = Parameters().getParam("vtk_format", std::string("base64"));
+    const char* names[] = {"ascii", "base64", "appendedraw", "zlib"};
+    for (int i = 0; i < 4; ++i)
+      if (name == names[i])
+        return Type(i);
+    DUNE_THROW(InvalidStateException, "unknown vtk_format " << name);
+  }
+
+  static VTK::OutputType duneType(const Type type) {
+    switch (type) {
+      case ascii:
+        return VTK::ascii;
+      case appendedraw:
+        return VTK::appendedraw;
+      default:
+        return VTK::base64;
+    }
+  }
+};
+
+/** \brief writes discrete functions to raw appended .vtu files, every data array zlib compressed on its own
+  * Like VTKOptions::nonconforming every element gets its own corners, functions are evaluated at the corners (point
+  * data) and at the center (cell data); no subsampling. The mesh arrays are encoded once and re-used for every file.
+  * The data arrays are compressed in parallel if OpenMP is enabled. Parallel runs write one piece per rank and a
+  * .pvtu on rank 0.
+  */
+template <class GridPartType>
+class CompressedVTUWriter {
+  typedef typename GridPartType::GridType GridType;
+  typedef typename GridPartType::template Codim<0>::IteratorType IteratorType;
+  typedef typename GridType::ctype ctype;
+  static const int dim = GridType::dimension;
+  typedef GenericReferenceElements<ctype, dim> ReferenceElementsType;
+
+  struct DataArray {
+    DataArray(const std::string& _name, const int _components)
+      : name(_name)
+      , components(_components) {}
+    std::string name;
+    int components;
+    std::vector<float> values;
+  };
+
+public:
+  //! \param level zlib compression level, see compressionLevel()
+  CompressedVTUWriter(const GridPartType& gridPart, const int level)
+    : gridPart_(gridPart)
+    , level_(level)
+    , points_(0)
+    , cells_(0) {}
+
+  static int compressionLevel() {
+    return Parameters().getParam("vtk_compression", 6, Dune::ValidateInterval<int, true, true>(0, 9));
+  }
+
+  //! evaluate \a function now, vector valued functions get an additional magnitude array
+  template <class DiscreteFunctionType>
+  void addFunction(const DiscreteFunctionType& function) {
+    typedef typename DiscreteFunctionType::RangeType RangeType;
+    const int dimRange = RangeType::dimension;
+    const int components = dimRange > 1 ? 3 : 1;
+    point_data_.push_back(DataArray(function.name(), components));
+    cell_data_.push_back(DataArray(function.name(), components));
+    DataArray& point_values = point_data_.back();
+    DataArray& cell_values = cell_data_.back();
+    std::vector<float> point_magnitude, cell_magnitude;
+    const IteratorType end = gridPart_.template end<0>();
+    for (IteratorType it = gridPart_.template begin<0>(); it != end; ++it) {
+      const typename DiscreteFunctionType::LocalFunctionType lf = function.localFunction(*it);
+      const typename ReferenceElementsType::ReferenceElement& reference = ReferenceElementsType::general(it->type());
+      RangeType value;
+      for (int corner = 0; corner < reference.size(dim); ++corner) {
+        lf.evaluate(reference.position(corner, dim), value);
+        append(point_values, value);
+        point_magnitude.push_back(value.two_norm());
+      }
+      lf.evaluate(reference.position(0, 0), value);
+      append(cell_values, value);
+      cell_magnitude.push_back(value.two_norm());
+    }
+    if (dimRange > 1) {
+      point_data_.push_back(DataArray(function.name() + "_magnitude", 1));
+      point_data_.back().values.swap(point_magnitude);
+      cell_data_.push_back(DataArray(function.name() + "_magnitude", 1));
+      cell_data_.back().values.swap(cell_magnitude);
+    }
+  }
+
+  //! writes \a filename.vtu (or the pieces and \a filename.pvtu) and forgets the functions
+  void write(const std::string& filename) {
+    if (mesh_.empty())
+      encodeMesh();
+    const int rank = gridPart_.grid().comm().rank();
+    const int size = gridPart_.grid().comm().size();
+    const std::string piece = size > 1 ? (boost::format("%s-p%04d") % filename % rank).str() : filename;
+
+    // everything but the mesh, in the order of the xml header
+    std::vector<const DataArray*> arrays;
+    for (size_t i = 0; i < point_data_.size(); ++i)
+      arrays.push_back(&point_data_[i]);
+    for (size_t i = 0; i < cell_data_.size(); ++i)
+      arrays.push_back(&cell_data_[i]);
+    std::vector<std::string> encoded(arrays.size());
+#if USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < int(arrays.size()); ++i)
+      encoded[i] = encode(bytes(arrays[i]->values), arrays[i]->values.size() * sizeof(float));
+
+    std::ofstream out((piece + ".vtu").c_str(), std::ios_base::out | std::ios_base::binary);
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << byteOrder()
+        << "\" header_type=\"UInt32\" compressor=\"vtkZLibDataCompressor\">\n"
+        << "<UnstructuredGrid>\n"
+        << "<Piece NumberOfPoints=\"" << points_ << "\" NumberOfCells=\"" << cells_ << "\">\n";
+    size_t offset = 0;
+    size_t index = 0;
+    out << "<PointData>\n";
+    for (size_t i = 0; i < point_data_.size(); ++i, ++index)
+      offset = header(out, "Float32", point_data_[i].name, point_data_[i].components, offset, encoded[index]);
+    out << "</PointData>\n<CellData>\n";
+    for (size_t i = 0; i < cell_data_.size(); ++i, ++index)
+      offset = header(out, "Float32", cell_data_[i].name, cell_data_[i].components, offset, encoded[index]);
+    out << "</CellData>\n<Points>\n";
+    offset = header(out, "Float32", "Coordinates", 3, offset, mesh_[0]);
+    out << "</Points>\n<Cells>\n";
+    offset = header(out, "Int32", "connectivity", 1, offset, mesh_[1]);
+    offset = header(out, "Int32", "offsets", 1, offset, mesh_[2]);
+    header(out, "UInt8", "types", 1, offset, mesh_[3]);
+    out << "</Cells>\n</Piece>\n</UnstructuredGrid>\n<AppendedData encoding=\"raw\">\n_";
+    for (size_t i = 0; i < encoded.size(); ++i)
+      out.write(encoded[i].data(), encoded[i].size());
+    for (size_t i = 0; i < mesh_.size(); ++i)
+      out.write(mesh_[i].data(), mesh_[i].size());
+    out << "\n</AppendedData>\n</VTKFile>\n";
+    if (!out)
+      DUNE_THROW(IOError, "writing " << piece << ".vtu failed");
+
+    if (size > 1 && rank == 0)
+      writeParallelHeader(filename, size);
+    clear();
+  }
+
+  void clear() {
+    point_data_.clear();
+    cell_data_.clear();
+  }
+
+private:
+  template <class RangeType>
+  static void append(DataArray& array, const RangeType& value) {
+    for (int i = 0; i < array.components; ++i)
+      array.values.push_back(i < int(RangeType::dimension) ? float(value[i]) : 0.0f);
+  }
+
+  //! ranks without elements have empty arrays
+  template <class T>
+  static const char* bytes(const std::vector<T>& values) {
+    return values.empty() ? "" : reinterpret_cast<const char*>(&values[0]);
+  }
+
+  static const char* byteOrder() {
+    const boost::uint16_t probe = 1;
+    return *reinterpret_cast<const char*>(&probe) == 1 ? "LittleEndian" : "BigEndian";
+  }
+
+  static size_t header(std::ostream& out, const std::string& type, const std::string& name, const int components,
+                       const size_t offset, const std::string& encoded) {
+    out << "<DataArray type=\"" << type << "\" Name=\"" << name << "\" NumberOfComponents=\"" << components
+        << "\" format=\"appended\" offset=\"" << offset << "\"/>\n";
+    return offset + encoded.size();
+  }
+
+  //! vtkZLibDataCompressor layout: #blocks, block size, size of the last block, compressed sizes, blocks
+  std::string encode(const char* data, const size_t bytes) const {
+    const size_t block_size = 1 << 15;
+    // an empty array (a rank without elements) has no blocks at all, readers take a last block size of 0 as full
+    const size_t blocks = (bytes + block_size - 1) / block_size;
+    std::vector<boost::uint32_t> head(3 + blocks);
+    head[0] = blocks;
+    head[1] = block_size;
+    head[2] = bytes % block_size;
+    std::string body;
+    std::vector<Bytef> buffer(compressBound(block_size));
+    for (size_t b = 0; b < blocks; ++b) {
+      const size_t begin = b * block_size;
+      const size_t length = std::min(block_size, bytes - begin);
+      uLongf compressed = buffer.size();
+      if (compress2(&buffer[0], &compressed, reinterpret_cast<const Bytef*>(data + begin), length, level_) != Z_OK)
+        DUNE_THROW(IOError, "zlib compression failed");
+      head[3 + b] = compressed;
+      body.append(reinterpret_cast<const char*>(&buffer[0]), compressed);
+    }
+    return std::string(reinterpret_cast<const char*>(&head[0]), head.size() * sizeof(boost::uint32_t)) + body;
+  }
+
+  void encodeMesh() {
+    std::vector<float> coordinates;
+    std::vector<boost::int32_t> connectivity, offsets;
+    std::vector<boost::uint8_t> types;
+    const IteratorType end = gridPart_.template end<0>();
+    for (IteratorType it = gridPart_.template begin<0>(); it != end; ++it) {
+      const int corners = it->geometry().corners();
+      for (int corner = 0; corner < corners; ++corner) {
+        const typename GridType::template Codim<0>::Geometry::GlobalCoordinate x = it->geometry().corner(corner);
+        for (int i = 0; i < 3; ++i)
+          coordinates.push_back(i < int(x.dimension) ? float(x[i]) : 0.0f);
+        connectivity.push_back(points_ + VTK::renumber(it->type(), corner));
+      }
+      points_ += corners;
+      offsets.push_back(points_);
+      types.push_back(VTK::geometryType(it->type()));
+      ++cells_;
+    }
+    mesh_.push_back(encode(bytes(coordinates), coordinates.size() * sizeof(float)));
+    mesh_.push_back(encode(bytes(connectivity), connectivity.size() * sizeof(boost::int32_t)));
+    mesh_.push_back(encode(bytes(offsets), offsets.size() * sizeof(boost::int32_t)));
+    mesh_.push_back(encode(bytes(types), types.size()));
+  }
+
+  void writeParallelHeader(const std::string& filename, const int size) const {
+    std::ofstream out((filename + ".pvtu").c_str());
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"PUnstructuredGrid\" version=\"0.1\" byte_order=\"" << byteOrder() << "\">\n"
+        << "<PUnstructuredGrid GhostLevel=\"0\">\n<PPointData>\n";
+    for (size_t i = 0; i < point_data_.size(); ++i)
+      out << "<PDataArray type=\"Float32\" Name=\"" << point_data_[i].name << "\" NumberOfComponents=\""
+          << point_data_[i].components << "\"/>\n";
+    out << "</PPointData>\n<PCellData>\n";
+    for (size_t i = 0; i < cell_data_.size(); ++i)
+      out << "<PDataArray type=\"Float32\" Name=\"" << cell_data_[i].name << "\" NumberOfComponents=\""
+          << cell_data_[i].components << "\"/>\n";
+    out << "</PCellData>\n<PPoints>\n<PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n</PPoints>\n";
+    const std::string base = boost::filesystem::path(filename).filename().string();
+    for (int rank = 0; rank < size; ++rank)
+      out << "<Piece Source=\"" << (boost::format("%s-p%04d") % base % rank).str() << ".vtu\"/>\n";
+    out << "</PUnstructuredGrid>\n</VTKFile>\n";
+  }
+
+  const GridPartType& gridPart_;
+  const int level_;
+  boost::int32_t points_;
+  boost::int32_t cells_;
+  //! coordinates, connectivity, offsets, types
+  std::vector<std::string> mesh_;
+  std::vector<DataArray> point_data_;
+  std::vector<DataArray> cell_data_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // VTUWRITER_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
@@ -0,0 +1,326 @@
+#ifndef XDMFWRITER_HH
+#define XDMFWRITER_HH
+
+#if ENABLE_HDF5
+
+#include <dune/fem/space/common/dofmanager.hh>
+#include <dune/grid/io/file/vtk/common.hh>
+#include <dune/grid/common/genericreferenceelements.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/stuff/parametercontainer.hh>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <hdf5.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+namespace Dune {
+namespace NavierStokes {
+
+/** \brief time series of discrete functions in a single HDF5 file per rank, indexed by an XDMF file for ParaView
+  * Like CompressedVTUWriter every element gets its own corners and functions are evaluated at the corners (node
+  * data) and centers (cell data). The mesh is stored once as /mesh<n>, a new one is only written after the grid
+  * changed (detected by the DofManager sequence). Every call of write() adds the group /step<k> holding one dataset
+  * per function and center. Rank 0 appends the step to prefix.xmf, parallel runs get a spatial collection of the
+  * per rank files prefix-p<rank>.h5 there.
+  */
+template <class GridPartType>
+class XdmfWriter {
+  typedef typename GridPartType::GridType GridType;
+  typedef typename GridPartType::template Codim<0>::IteratorType IteratorType;
+  typedef typename GridType::ctype ctype;
+  static const int dim = GridType::dimension;
+  typedef GenericReferenceElements<ctype, dim> ReferenceElementsType;
+
+  struct Field {
+    Field(const std::string& _name, const int _components, const bool _cell)
+      : name(_name)
+      , components(_components)
+      , cell(_cell) {}
+    std::string name;
+    int components;
+    bool cell;
+    std::vector<float> values;
+  };
+
+public:
+  //! \param prefix path and file name prefix, \param level deflate level of the datasets, see compressionLevel()
+  XdmfWriter(const GridPartType& gridPart, const std::string& prefix, const int level)
+    : gridPart_(gridPart)
+    , dof_manager_(DofManager<GridType>::instance(gridPart.grid()))
+    , rank_(gridPart.grid().comm().rank())
+    , size_(gridPart.grid().comm().size())
+    , prefix_(prefix)
+    , level_(level)
+    , file_(-1)
+    , mesh_sequence_(-1)
+    , meshes_(0)
+    , steps_(0)
+    , xml_end_(0)
+    , cell_type_(0) {
+    file_ = H5Fcreate(dataFile(rank_).c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if (file_ < 0)
+      DUNE_THROW(IOError, "could not create " << dataFile(rank_));
+  }
+
+  ~XdmfWriter() {
+    if (file_ >= 0)
+      H5Fclose(file_);
+  }
+
+  static int compressionLevel() {
+    return Parameters().getParam("hdf5_compression", 0, Dune::ValidateInterval<int, true, true>(0, 9));
+  }
+
+  //! evaluate \a function now, vector valued functions are padded to three components
+  template <class DiscreteFunctionType>
+  void addFunction(const DiscreteFunctionType& function) {
+    typedef typename DiscreteFunctionType::RangeType RangeType;
+    const int components = RangeType::dimension > 1 ? 3 : 1;
+    fields_.push_back(Field(function.name(), components, false));
+    fields_.push_back(Field(function.name() + "_cell", components, true));
+    Field& node_values = fields_[fields_.size() - 2];
+    Field& cell_values = fields_.back();
+    const IteratorType end = gridPart_.template end<0>();
+    for (IteratorType it = gridPart_.template begin<0>(); it != end; ++it) {
+      const typename DiscreteFunctionType::LocalFunctionType lf = function.localFunction(*it);
+      const typename ReferenceElementsType::ReferenceElement& reference = ReferenceElementsType::general(it->type());
+      RangeType value;
+      for (int corner = 0; corner < reference.size(dim); ++corner) {
+        lf.evaluate(reference.position(corner, dim), value);
+        append(node_values, value);
+      }
+      lf.evaluate(reference.position(0, 0), value);
+      append(cell_values, value);
+    }
+  }
+
+  //! stores the added functions as the step at \a time, needs to be called on all ranks
+  void write(const double time) {
+    if (mesh_sequence_ != dof_manager_.sequence())
+      writeMesh();
+    const std::string group = (boost::format("/step%06d") % steps_).str();
+    for (size_t i = 0; i < fields_.size(); ++i) {
+      const Field& field = fields_[i];
+      dataset(group + "/" + field.name, H5T_NATIVE_FLOAT, field.values, field.values.size() / field.components,
+              field.components);
+    }
+    H5Fflush(file_, H5F_SCOPE_LOCAL);
+    if (rank_ == 0)
+      appendStep(time, group);
+    ++steps_;
+    fields_.clear();
+  }
+
+private:
+  template <class RangeType>
+  static void append(Field& field, const RangeType& value) {
+    for (int i = 0; i < field.components; ++i)
+      field.values.push_back(i < int(RangeType::dimension) ? float(value[i]) : 0.0f);
+  }
+
+  std::string dataFile(const int rank) const {
+    return size_ > 1 ? (boost::format("%s-p%04d.h5") % prefix_ % rank).str() : prefix_ + ".h5";
+  }
+
+  //! XdmfTopologyType and nodes per element of a VTK cell type
+  static std::pair<std::string, int> topology(const int vtk_type) {
+    switch (vtk_type) {
+      case VTK::line:
+        return std::make_pair("Polyline", 2);
+      case VTK::triangle:
+        return std::make_pair("Triangle", 3);
+      case VTK::quadrilateral:
+        return std::make_pair("Quadrilateral", 4);
+      case VTK::tetrahedron:
+        return std::make_pair("Tetrahedron", 4);
+      case VTK::hexahedron:
+        return std::make_pair("Hexahedron", 8);
+      default:
+        DUNE_THROW(NotImplemented, "no XDMF topology for VTK cell type " << vtk_type);
+    }
+  }
+
+  template <class T>
+  void dataset(const std::string& name, const hid_t type, const std::vector<T>& values, const hsize_t rows,
+               const hsize_t columns) {
+    const hsize_t dims[2] = {rows, columns};
+    const hid_t space = H5Screate_simple(2, dims, NULL);
+    const hid_t link = H5Pcreate(H5P_LINK_CREATE);
+    H5Pset_create_intermediate_group(link, 1);
+    const hid_t create = H5Pcreate(H5P_DATASET_CREATE);
+    if (level_ > 0 && rows > 0) {
+      const hsize_t chunk[2] = {std::min(rows, hsize_t(1 << 14)), columns};
+      H5Pset_chunk(create, 2, chunk);
+      H5Pset_deflate(create, level_);
+    }
+    const hid_t set = H5Dcreate2(file_, name.c_str(), type, space, link, create, H5P_DEFAULT);
+    herr_t status = set;
+    // ranks without elements only create the empty dataset
+    if (set >= 0 && !values.empty())
+      status = H5Dwrite(set, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, &values[0]);
+    if (set >= 0)
+      H5Dclose(set);
+    H5Pclose(create);
+    H5Pclose(link);
+    H5Sclose(space);
+    if (status < 0)
+      DUNE_THROW(IOError, "writing dataset " << name << " to " << dataFile(rank_) << " failed");
+  }
+
+  void writeMesh() {
+    std::vector<float> coordinates;
+    std::vector<int> connectivity;
+    int points = 0;
+    int cells = 0;
+    int cell_type = 0;
+    const IteratorType end = gridPart_.template end<0>();
+    for (IteratorType it = gridPart_.template begin<0>(); it != end; ++it) {
+      const int type = VTK::geometryType(it->type());
+      if (cell_type != 0 && type != cell_type)
+        DUNE_THROW(NotImplemented, "XDMF output of grids with mixed element types");
+      cell_type = type;
+      const int corners = it->geometry().corners();
+      for (int corner = 0; corner < corners; ++corner) {
+        const typename GridType::template Codim<0>::Geometry::GlobalCoordinate x = it->geometry().corner(corner);
+        for (int i = 0; i < 3; ++i)
+          coordinates.push_back(i < int(x.dimension) ? float(x[i]) : 0.0f);
+        connectivity.push_back(points + VTK::renumber(it->type(), corner));
+      }
+      points += corners;
+      ++cells;
+    }
+    // ranks without elements don't know the element type
+    cell_type = gridPart_.grid().comm().max(cell_type);
+    const int corners = topology(cell_type).second;
+    mesh_group_ = (boost::format("/mesh%d") % meshes_).str();
+    dataset(mesh_group_ + "/geometry", H5T_NATIVE_FLOAT, coordinates, points, 3);
+    dataset(mesh_group_ + "/topology", H5T_NATIVE_INT, connectivity, cells, corners);
+
+    // the index on rank 0 needs the sizes of all pieces
+    piece_sizes_.assign(2 * size_, 0);
+    piece_sizes_[2 * rank_] = points;
+    piece_sizes_[2 * rank_ + 1] = cells;
+    gridPart_.grid().comm().sum(&piece_sizes_[0], piece_sizes_.size());
+    cell_type_ = cell_type;
+    mesh_sequence_ = dof_manager_.sequence();
+    ++meshes_;
+  }
+
+  std::string dataItem(const std::string& file, const std::string& path, const int rows, const int columns,
+                       const bool integer) const {
+    return (boost::format("<DataItem Format=\"HDF\" NumberType=\"%s\" Precision=\"4\" Dimensions=\"%d %d\">%s:%s"
+                          "</DataItem>\n") %
+            (integer ? "Int" : "Float") % rows % columns % file % path).str();
+  }
+
+  std::string uniformGrid(const int rank, const std::string& group) const {
+    const std::string file = boost::filesystem::path(dataFile(rank)).filename().string();
+    const int points = piece_sizes_[2 * rank];
+    const int cells = piece_sizes_[2 * rank + 1];
+    const std::pair<std::string, int> topo = topology(cell_type_);
+    std::ostringstream xml;
+    xml << "<Grid Name=\"" << (boost::format("p%04d") % rank).str() << "\" GridType=\"Uniform\">\n"
+        << "<Topology TopologyType=\"" << topo.first << "\" NumberOfElements=\"" << cells << "\" NodesPerElement=\""
+        << topo.second << "\">\n" << dataItem(file, mesh_group_ + "/topology", cells, topo.second, true)
+        << "</Topology>\n<Geometry GeometryType=\"XYZ\">\n"
+        << dataItem(file, mesh_group_ + "/geometry", points, 3, false) << "</Geometry>\n";
+    for (size_t i = 0; i < fields_.size(); ++i) {
+      const Field& field = fields_[i];
+      xml << "<Attribute Name=\"" << field.name << "\" AttributeType=\""
+          << (field.components > 1 ? "Vector" : "Scalar") << "\" Center=\"" << (field.cell ? "Cell" : "Node")
+          << "\">\n" << dataItem(file, group + "/" + field.name, field.cell ? cells : points, field.components, false)
+          << "</Attribute>\n";
+    }
+    xml << "</Grid>\n";
+    return xml.str();
+  }
+
+  //! the closing tags are overwritten by the next step, so the index is valid after every write
+  void appendStep(const double time, const std::string& group) {
+    const std::string filename = prefix_ + ".xmf";
+    const std::string closing = "</Grid>\n</Domain>\n</Xdmf>\n";
+    std::ostringstream xml;
+    if (size_ > 1) {
+      xml << "<Grid Name=\"" << group.substr(1) << "\" GridType=\"Collection\" CollectionType=\"Spatial\">\n"
+          << (boost::format("<Time Value=\"%.12g\"/>\n") % time).str();
+      for (int rank = 0; rank < size_; ++rank)
+        xml << uniformGrid(rank, group);
+      xml << "</Grid>\n";
+    } else {
+      std::string grid = uniformGrid(0, group);
+      // a single piece carries the time itself
+      grid.insert(grid.find('\n') + 1, (boost::format("<Time Value=\"%.12g\"/>\n") % time).str());
+      xml << grid;
+    }
+    std::fstream out;
+    if (steps_ == 0) {
+      out.open(filename.c_str(), std::ios_base::out | std::ios_base::trunc);
+      out << "<?xml version=\"1.0\"?>\n<Xdmf Version=\"2.0\">\n<Domain>\n"
+          << "<Grid Name=\"TimeSeries\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+    } else {
+      out.open(filename.c_str(), std::ios_base::in | std::ios_base::out);
+      out.seekp(xml_end_);
+    }
+    out << xml.str();
+    xml_end_ = out.tellp();
+    out << closing;
+    if (!out)
+      DUNE_THROW(IOError, "writing " << filename << " failed");
+  }
+
+  const GridPartType& gridPart_;
+  const DofManager<GridType>& dof_manager_;
+  const int rank_;
+  const int size_;
+  const std::string prefix_;
+  const int level_;
+  hid_t file_;
+  int mesh_sequence_;
+  int meshes_;
+  int steps_;
+  std::streamoff xml_end_;
+  std::string mesh_group_;
+  int cell_type_;
+  //! points and cells of every rank for the current mesh
+  std::vector<int> piece_sizes_;
+  std::vector<Field> fields_;
+};
+
+} // end namespace NavierStokes
+} // end namespace Dune
+
+#endif // ENABLE_HDF5
+
+#endif // XDMFWRITER_HH
+
+/** Copyright (c) 2012, Rene Milk
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the FreeBSD Project.
+**/
@@ -140,6 +140,7 @@ int main(int argc, char** argv) {
 
 Stuff::RunInfoVector singleRun(CollectiveCommunication& mpicomm, int refine_level_factor) {
   profiler().StartTiming("SingleRun");
+  Dune::NavierStokes::runConfig().refresh();
   Logging::LogStream& infoStream = Logger().Info();
   Logging::LogStream& debugStream = Logger().Dbg();
   Stuff::RunInfoVector runInfoVector;
@@ -19,6 +19,15 @@ Stuff::RunInfoTimeMap singleRun(CollectiveCommunication& mpicomm, const int refi
 
 bool setSchemeTypeFromString();
 
+//! the cached grid must not outlive the communicator it was built on
+void releaseCommunicator(CollectiveCommunication& comm) {
+#if ENABLE_MPI
+  gridCache().release(comm);
+#else
+  gridCache().clear();
+#endif
+}
+
 /**
  *  \brief  main function
  *
@@ -39,21 +48,24 @@ int main(int argc, char** argv) {
   const unsigned int minref = Parameters().getParam("minref", 0, Dune::ValidateNotLess<int>(0));
   Stuff::RunInfoTimeMapMap rf;
   const int runtype = Parameters().getParam("runtype", 5);
+  // only grid refinement runs form a chain of coarse to fine runs on one hierarchy a previous end state can seed
+  if (runtype >= 6 && runtype <= 8 && Parameters().getParam("nested_iteration", false)) {
+    Logger().Err() << "nested_iteration is only meaningful for grid refinement runs (runtype 0/5), ignoring it\n";
+    Parameters().setParam("nested_iteration", false);
+  }
+  // the loops of the different run types only differ in the list of independent runs they expand to
+  typedef Dune::NavierStokes::CampaignJob CampaignJob;
+  Dune::NavierStokes::Campaign<CollectiveCommunication>::JobList jobs;
   switch (runtype) {
     case 8: {
       Logger().Info() << "Reynolds runs\n";
       const int dt_steps = Parameters().getParam("dt_steps", 3, Dune::ValidateNotLess<int>(2));
       profiler().Reset(dt_steps - 1);
-      int current_step = 0;
-      Stuff::LoopTimer<int, Stuff::Logging::LogStream> loop_timer(current_step, dt_steps, Logger().Info());
-      for (double viscosity = Parameters().getParam("viscosity", 0.1, Dune::ValidateNotLess<double>(0.0));
-           dt_steps > current_step; ++loop_timer) {
-        rf[current_step] = singleRun(mpicomm, minref, Parameters().getParam("scheme_type", 1, true));
-        assert(rf.size());
-        rf[current_step].begin()->second.refine_level = minref; // just in case the key changes from ref to sth else
-        profiler().NextRun();
+      double viscosity = Parameters().getParam("viscosity", 0.1, Dune::ValidateNotLess<double>(0.0));
+      for (int current_step = 0; dt_steps > current_step; ++current_step) {
+        jobs.push_back(CampaignJob(current_step, minref, Parameters().getParam("scheme_type", 1, true)));
+        jobs.back().overrides.push_back(std::make_pair(std::string("viscosity"), viscosity));
         viscosity /= 10.0f;
-        Parameters().setParam("viscosity", viscosity);
       }
       break;
     }
@@ -61,31 +73,19 @@ int main(int argc, char** argv) {
       Logger().Info() << "Time refine runs\n";
       const int dt_steps = Parameters().getParam("dt_steps", 3, Dune::ValidateNotLess<int>(2));
       profiler().Reset(dt_steps - 1);
-      int current_step = 0;
-      Stuff::LoopTimer<int, Stuff::Logging::LogStream, Stuff::QuadraticWeights> loop_timer(current_step, dt_steps,
-                                                                                           Logger().Info());
-      for (double dt = Parameters().getParam("fem.timeprovider.dt", 0.1, Dune::ValidateNotLess<double>(0.0));
-           dt_steps > current_step; ++loop_timer) {
-        rf[current_step] = singleRun(mpicomm, minref, Parameters().getParam("scheme_type", 1, true));
-        assert(rf.size());
-        rf[current_step].begin()->second.refine_level = minref; // just in case the key changes from ref to sth else
-        profiler().NextRun();
+      double dt = Parameters().getParam("fem.timeprovider.dt", 0.1, Dune::ValidateNotLess<double>(0.0));
+      for (int current_step = 0; dt_steps > current_step; ++current_step) {
+        jobs.push_back(CampaignJob(current_step, minref, Parameters().getParam("scheme_type", 1, true)));
+        jobs.back().overrides.push_back(std::make_pair(std::string("fem.timeprovider.dt"), dt));
         dt /= 2.0f;
-        Parameters().setParam("fem.timeprovider.dt", dt);
       }
       break;
     }
     case 7: {
       Logger().Info() << "Scheme runs\n";
       profiler().Reset(4);
-      int current_scheme = 2;
-      Stuff::LoopTimer<int, Stuff::Logging::LogStream> loop_timer(current_scheme, 5, Logger().Info());
-      for (; current_scheme < 6; ++loop_timer) {
-        rf[current_scheme] = singleRun(mpicomm, minref, current_scheme);
-        assert(rf.size());
-        rf[current_scheme].begin()->second.refine_level = minref; // just in case the key changes from ref to sth else
-        profiler().NextRun();
-      }
+      for (int current_scheme = 2; current_scheme < 6; ++current_scheme)
+        jobs.push_back(CampaignJob(current_scheme, minref, current_scheme));
       break;
     }
     case 5:
@@ -97,18 +97,34 @@ int main(int argc, char** argv) {
                                                Parameters().getParam("maxref", (unsigned int)(0)));
       profiler().Reset(maxref - minref + 1);
       Logger().Info() << "Grid refine runs\n";
-      unsigned int ref = minref;
-      Stuff::LoopTimer<unsigned int, Stuff::Logging::LogStream, Stuff::LinearWeights> loop_timer(
-          ref, maxref - minref + 1, Logger().Info());
-      for (; ref <= maxref; ++loop_timer) {
-        rf[ref] = singleRun(mpicomm, ref, Parameters().getParam("scheme_type", 1, true));
-        rf[ref].begin()->second.refine_level = ref; // just in case the key changes from ref to sth else
-        profiler().NextRun();
-      }
+      for (unsigned int ref = minref; ref <= maxref; ++ref)
+        jobs.push_back(CampaignJob(ref, ref, Parameters().getParam("scheme_type", 1, true)));
       break;
     }
   }
-  profiler().OutputMap(mpicomm, rf);
+  // a snapshot belongs to exactly one run, neither the runs of a study nor parareal's slices may all resume from it
+  if (!Parameters().getParam("checkpoint_restart", std::string()).empty() &&
+      (jobs.size() > 1 || Parameters().getParam("parareal", false))) {
+    Logger().Err() << "checkpoint_restart only applies to a single run without parareal, starting from scratch\n";
+    Parameters().setParam("checkpoint_restart", std::string());
+  }
+  // same progress weights as the sequential loops used to have
+  typedef Stuff::Logging::LogStream LogStream;
+  switch (runtype) {
+    case 6:
+      Dune::NavierStokes::Campaign<CollectiveCommunication, Stuff::LoopTimer<int, LogStream, Stuff::QuadraticWeights>>(
+          mpicomm).run(jobs, &singleRun, rf, &releaseCommunicator);
+      break;
+    case 7:
+    case 8:
+      Dune::NavierStokes::Campaign<CollectiveCommunication>(mpicomm).run(jobs, &singleRun, rf, &releaseCommunicator);
+      break;
+    default:
+      Dune::NavierStokes::Campaign<CollectiveCommunication, Stuff::LoopTimer<int, LogStream, Stuff::LinearWeights>>(
+          mpicomm).run(jobs, &singleRun, rf, &releaseCommunicator);
+      break;
+  }
+  gridCache().clear();
 
   if (NAVIER_DATA_NAMESPACE::hasExactSolution && Parameters().getParam("calculate_errors", true)) {
     Stuff::TimeSeriesOutput out(rf);
@@ -124,12 +140,21 @@ Stuff::RunInfoTimeMap singleRun(CollectiveCommunication& mpicomm, const int refi
   Stuff::Profiler::ScopedTiming pf_t("SingleRun");
   Stuff::Logging::LogStream& infoStream = Logger().Info();
   Stuff::Logging::LogStream& debugStream = Logger().Dbg();
+  // campaign jobs override parameters between runs
+  Dune::NavierStokes::runConfig().refresh();
 
   infoStream << "\n- initialising grid" << std::endl;
   const int gridDim = GridType::dimensionworld;
-  Dune::GridPtr<GridType> gridPtr(Parameters().DgfFilename(gridDim));
+  // parareal parallelizes in time, every rank needs the whole grid for itself then
+  const bool parareal = Parameters().getParam("parareal", false);
   const int refine_level = (refine_level_factor) * Dune::DGFGridInfo<GridType>::refineStepsForHalf();
-  gridPtr->globalRefine(refine_level);
+#if ENABLE_MPI
+  CollectiveCommunication local_comm(parareal ? MPI_COMM_SELF : MPI_Comm(mpicomm));
+  GridType& grid = gridCache().get(Parameters().DgfFilename(gridDim), refine_level, local_comm);
+#else
+  CollectiveCommunication local_comm(mpicomm);
+  GridType& grid = gridCache().get(Parameters().DgfFilename(gridDim), refine_level);
+#endif
 
   const int polOrder = POLORDER;
   debugStream << "  - polOrder: " << polOrder << std::endl;
@@ -137,7 +162,15 @@ Stuff::RunInfoTimeMap singleRun(CollectiveCommunication& mpicomm, const int refi
   //    infoStream << (boost::format("  - max grid width: %f\n") % grid_width) << std::endl;
 
   try {
-    return ThetaschemeRunner<GridType, CollectiveCommunication>(*gridPtr, mpicomm).run(scheme_type);
+    typedef ThetaschemeRunner<GridType, CollectiveCommunication> RunnerType;
+    if (parareal) {
+      RunnerType runner(grid, local_comm);
+      return Dune::NavierStokes::Parareal<RunnerType, CollectiveCommunication>(runner, mpicomm).run(scheme_type);
+    }
+    // nested iteration: start from the solution of the previous, coarser run on the cached grid
+    if (Parameters().getParam("nested_iteration", false))
+      return RunnerType(grid, mpicomm).run(scheme_type, gridCache().solution(), true);
+    return RunnerType(grid, mpicomm).run(scheme_type);
   }
   catch (Dune::Exception& e) {
     std::cerr << "Dune reported error: " << e.what() << std::endl;
@@ -161,7 +194,7 @@ bool setSchemeTypeFromString() {
   if (Dune::Parameter::exists("scheme_type_string")) {
     const std::vector<std::string>& scheme_names = Dune::NavierStokes::ThetaSchemeDescription<0>::scheme_names;
     Stuff::ValidateInList<std::string> validator(scheme_names);
-    const std::string scheme_string = Parameters().getParam("scheme_type_string", scheme_names.back(), validator);
+    const std::string scheme_string = Parameters().getParam("scheme_type_string", scheme_names[5], validator);
     const int scheme_id = Stuff::getIdx(scheme_names, scheme_string);
     Parameters().setParam("scheme_type", scheme_id);
     changed = true;
@@ -56,6 +56,9 @@ typedef Dune::GridSelector::GridType GridType;
 #include <dune/stuff/runinfo.hh>
 
 #include <dune/navier/thetascheme_runner.hh>
+#include <dune/navier/parareal.hh>
+#include <dune/navier/campaign.hh>
+#include <dune/navier/gridcache.hh>
 #include <dune/navier/fractionaldatawriter.hh>
 
 #if ENABLE_MPI
@@ -64,6 +67,12 @@ typedef Dune::CollectiveCommunication<MPI_Comm> CollectiveCommunication;
 typedef Dune::CollectiveCommunication<double> CollectiveCommunication;
 #endif
 
+//! grids outlive single runs, see GridCache
+Dune::NavierStokes::GridCache<GridType>& gridCache() {
+  static Dune::NavierStokes::GridCache<GridType> cache;
+  return cache;
+}
+
 //! the strings used for column headers in tex output
 typedef std::vector<std::string> ColumnHeaders;
 
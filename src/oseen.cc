@@ -122,6 +122,7 @@ Stuff::RunInfoVector singleRun(CollectiveCommunication& comm, int refine_level_f
 
   //	Parameters().setParam( "lambda", lambda );
   Parameters().setParam("viscosity", oseen_viscosity);
+  Dune::NavierStokes::runConfig().refresh();
   Dune::StabilizationCoefficients stab_coeff = Dune::StabilizationCoefficients::getDefaultStabilizationCoefficients();
   //	stab_coeff.FactorFromParams( "D12", 0 );
   //	stab_coeff.FactorFromParams( "C12", 0 );
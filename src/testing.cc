@@ -117,6 +117,7 @@ Stuff::RunInfoVector singleRun(CollectiveCommunication& mpicomm, int refine_leve
 
   Parameters().setParam("lambda", lambda);
   Parameters().setParam("viscosity", oseen_viscosity);
+  Dune::NavierStokes::runConfig().refresh();
   Dune::StabilizationCoefficients stab_coeff = Dune::StabilizationCoefficients::getDefaultStabilizationCoefficients();
   stab_coeff.FactorFromParams("D12", 0);
   stab_coeff.FactorFromParams("C12", 0);
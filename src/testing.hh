@@ -4,6 +4,7 @@
 #include <dune/stuff/misc.hh>
 #include <dune/stuff/timefunction.hh>
 #include <dune/stuff/parametercontainer.hh>
+#include <dune/navier/runconfig.hh>
 #include <dune/common/tuples.hh>
 
 #include <boost/format.hpp>
@@ -351,7 +352,7 @@ public:
    *          value of force at given point
    **/
   inline void evaluate(const double time, const DomainType& arg, RangeType& ret) const {
-    const double viscosity = Parameters().getParam("viscosity", 1.0);
+    const double viscosity = Dune::NavierStokes::runConfig().viscosity;
     const double x = arg[0];
     const double y = arg[1];
     // conv
@@ -737,7 +738,7 @@ public:
     ret[0] += (-2 * std::pow(evals.P, 2) * evals.v) * u[0];
     ret[1] += (-2 * std::pow(evals.P, 2) * evals.v) * u[1];
 
-    ret *= Parameters().getParam("rhs_factor", 1.0);
+    ret *= Dune::NavierStokes::runConfig().rhs_factor;
   }
   inline void evaluate(const DomainType& /*arg*/, RangeType& ret) const { assert(false); }
 